@@ -0,0 +1,94 @@
+#include "bit_vector.hpp"
+#include <iostream>
+
+//==================================================================================================
+
+static void print_header(const char *header)
+{
+    std::cout <<
+        "----------------------\n" <<
+        header << '\n' <<
+        "----------------------\n";
+}
+
+int main()
+{
+    my_std::bit_vector<> bits;
+
+    print_header("push_back(i % 3 == 0) x 70");
+    for (int i = 0; i < 70; ++i)
+        bits.push_back(i % 3 == 0);
+    std::cout << bits;
+    std::cout << "words = " << bits.words().size() << ", count() = " << bits.count() << "\n";
+
+    print_header("find_first(), find_next(...)");
+    for (size_t pos = bits.find_first(); pos < bits.size() && pos < 20; pos = bits.find_next(pos))
+        std::cout << pos << " ";
+    std::cout << "\n";
+
+    print_header("rank(...), select(...)");
+    std::cout << "rank(0) = " << bits.rank(0) << ", rank(64) = " << bits.rank(64) << ", rank(70) = " << bits.rank(70) << "\n";
+    std::cout << "select(0) = " << bits.select(0) << ", select(22) = " << bits.select(22) <<
+                 ", select(23) = " << bits.select(23) << " (size = " << bits.size() << ")\n";
+
+    print_header("rank(...), select(...) of 5000 bits against a scan, before and after updates");
+    {
+        my_std::bit_vector<> big;
+        for (size_t i = 0; i < 5000; ++i)
+            big.push_back(i * i % 7 < 3);
+
+        auto mismatches = [&big]()
+        {
+            size_t errors = 0, ones = 0;
+            for (size_t pos = 0; pos < big.size(); ++pos)
+            {
+                errors += big.rank(pos) != ones;
+                if (big[pos])
+                    errors += big.select(ones++) != pos;
+            }
+            errors += big.rank(big.size()) != ones;
+            errors += big.select(ones) != big.size();
+            return errors;
+        };
+
+        std::cout << "count() = " << big.count() << ", mismatches = " << mismatches() << "\n";
+
+        // a reference taken before the query writes after it
+        auto ref = big[4000];
+        std::cout << "rank(4500) = " << big.rank(4500);
+        ref.flip();
+        std::cout << ", after big[4000].flip(): rank(4500) = " << big.rank(4500) << "\n";
+
+        for (size_t pos = 0; pos < big.size(); pos += 3)
+            big[pos] = true;
+        big.resize(4321);
+        std::cout << "count() = " << big.count() << ", mismatches = " << mismatches() << "\n";
+    }
+
+    print_header("proxy reference: bits[1] = true, bits[0].flip(), bits[2] = bits[1]");
+    bits[1] = true;
+    bits[0].flip();
+    bits[2] = bits[1];
+    std::cout << bits;
+
+    print_header("and / or / xor with bit_vector(70, true) minus the last bit");
+    my_std::bit_vector<> ones(70, true);
+    ones.pop_back();
+    ones.push_back(false);
+    std::cout << "count(a & b) = " << (bits & ones).count() << "\n";
+    std::cout << "count(a | b) = " << (bits | ones).count() << "\n";
+    std::cout << "count(a ^ b) = " << (bits ^ ones).count() << "\n";
+
+    print_header("flip(), resize(130, true), resize(65)");
+    bits.flip();
+    std::cout << "count() = " << bits.count() << "\n";
+    bits.resize(130, true);
+    std::cout << "count() = " << bits.count() << ", size() = " << bits.size() << "\n";
+    bits.resize(65);
+    std::cout << bits;
+
+    print_header("pop_back() to empty");
+    while (!bits.empty())
+        bits.pop_back();
+    std::cout << "words = " << bits.words().size() << ", find_first() = " << bits.find_first() << "\n";
+}
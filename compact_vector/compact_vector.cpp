@@ -0,0 +1,136 @@
+#include "compact_vector.hpp"
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+//==================================================================================================
+
+static void print_header(const char *header)
+{
+    std::cout <<
+        "----------------------\n" <<
+        header << '\n' <<
+        "----------------------\n";
+}
+
+template <class Vector>
+static void print_elements(const Vector &vec)
+{
+    std::cout << "size = " << vec.size() << ", capacity = " << vec.capacity() << " {";
+    for (const auto &elem : vec)
+        std::cout << " " << elem;
+    std::cout << " }\n";
+}
+
+// Copies throw once copies_left runs out, moves never throw.
+struct throwing_t
+{
+    throwing_t(int value) : value(value) {}
+
+    throwing_t(const throwing_t &other) : value(other.value)
+    {
+        if (copies_left-- == 0)
+            throw std::runtime_error("copy");
+    }
+
+    throwing_t(throwing_t &&other) noexcept = default;
+
+    throwing_t &operator=(const throwing_t &other) = default;
+    throwing_t &operator=(throwing_t &&other) noexcept = default;
+
+    friend std::ostream &operator<<(std::ostream &os, const throwing_t &elem)
+    {
+        return os << elem.value;
+    }
+
+    int value;
+
+    static inline int copies_left = -1;
+};
+
+int main()
+{
+    print_header("sizeof");
+    std::cout << "sizeof(compact_vector<int>) = " << sizeof(my_std::compact_vector<int>) <<
+                 ", sizeof(vector<int>) = " << sizeof(my_std::vector<int>) << "\n";
+
+    my_std::compact_vector<int> vec;
+
+    print_header("empty vector holds no block");
+    std::cout << "data() = " << vec.data() << ", size = " << vec.size() << "\n";
+
+    print_header("push_back(...) x 10");
+    for (int i = 0; i < 10; ++i)
+        vec.push_back(i);
+    print_elements(vec);
+
+    print_header("insert(begin() + 2, 3, vec[9]), erase(begin() + 5, begin() + 8)");
+    vec.insert(vec.begin() + 2, 3, vec[9]);
+    print_elements(vec);
+    vec.erase(vec.begin() + 5, vec.begin() + 8);
+    print_elements(vec);
+
+    print_header("insert(end(), begin(), begin() + 7): source inside the vector, growth");
+    vec.insert(vec.end(), vec.begin(), vec.begin() + 7);
+    print_elements(vec);
+
+    print_header("resize(4), shrink_to_fit()");
+    vec.resize(4);
+    vec.shrink_to_fit();
+    print_elements(vec);
+
+    print_header("insert(begin() + 1, 3, value) when the second copy throws, reserve(max_size() + 1)");
+    {
+        my_std::compact_vector<throwing_t> throwing;
+        throwing.reserve(8);
+        for (int i = 0; i < 4; ++i)
+            throwing.emplace_back(i);
+
+        throwing_t value(9);
+        throwing_t::copies_left = 1;
+        try
+        {
+            throwing.insert(throwing.begin() + 1, 3, value);
+        }
+        catch (const std::runtime_error &)
+        {
+            std::cout << "runtime_error: ";
+        }
+        throwing_t::copies_left = -1;
+        print_elements(throwing);
+
+        try
+        {
+            throwing.reserve(throwing.max_size() + 1);
+        }
+        catch (const std::length_error &)
+        {
+            std::cout << "length_error: ";
+        }
+        print_elements(throwing);
+    }
+
+    my_std::compact_vector<std::string> strings{"alpha", "beta", "gamma"};
+
+    print_header("compact_vector<std::string>: emplace(begin(), ...), erase(begin() + 2)");
+    strings.emplace(strings.begin(), 20, 'x');
+    strings.erase(strings.begin() + 2);
+    print_elements(strings);
+
+    print_header("compact_vector<std::string>: copy, move, assign(istream_iterator)");
+    my_std::compact_vector<std::string> copy(strings);
+    my_std::compact_vector<std::string> moved(std::move(strings));
+    std::cout << "copy == moved: " << (copy == moved) << ", source empty: " << strings.empty() << "\n";
+
+    std::istringstream input("one two three four");
+    copy.assign(std::istream_iterator<std::string>(input), std::istream_iterator<std::string>());
+    print_elements(copy);
+
+    copy = moved;
+    print_elements(copy);
+
+    copy.clear();
+    copy.shrink_to_fit();
+    std::cout << "clear() + shrink_to_fit(): data() = " << copy.data() << "\n";
+}
@@ -0,0 +1,107 @@
+#include "concurrent_vector.hpp"
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+//==================================================================================================
+
+static const int thread_count      = 8;
+static const int pushes_per_thread = 10000;
+
+static void print_header(const char *header)
+{
+    std::cout <<
+        "----------------------\n" <<
+        header << '\n' <<
+        "----------------------\n";
+}
+
+// Throws bad_alloc once allocations_left reaches 0.
+template <class T>
+struct failing_allocator: std::allocator<T>
+{
+    template <class U>
+    struct rebind { using other = failing_allocator<U>; };
+
+    failing_allocator() = default;
+
+    template <class U>
+    failing_allocator(const failing_allocator<U> &) {}
+
+    T *allocate(size_t count)
+    {
+        if (allocations_left == 0)
+            throw std::bad_alloc();
+
+        --allocations_left;
+        return std::allocator<T>::allocate(count);
+    }
+
+    static inline int allocations_left = -1;
+};
+
+int main()
+{
+    my_std::concurrent_vector<long> vec;
+    const long *first_elem = nullptr;
+
+    {
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < thread_count; ++thread)
+        {
+            threads.emplace_back([&vec, thread]()
+            {
+                for (int i = 0; i < pushes_per_thread; ++i)
+                    vec.push_back(long(thread) * pushes_per_thread + i);
+            });
+        }
+
+        vec.push_back(-1);
+        first_elem = &vec[0];
+
+        for (std::thread &thread : threads)
+            thread.join();
+    }
+
+    print_header("push_back(...) from 8 threads x 10000 + 1 from the main thread");
+    std::cout << "size = " << vec.size() << "\n";
+
+    std::vector<long> sorted(vec.begin(), vec.end());
+    std::sort(sorted.begin(), sorted.end());
+
+    bool all_present = sorted.front() == -1;
+    for (size_t idx = 1; idx < sorted.size(); ++idx)
+        all_present = all_present && sorted[idx] == long(idx - 1);
+
+    std::cout << "every value is present once: " << all_present << "\n";
+    std::cout << "address of element #0 is stable: " << (first_elem == &vec[0]) << "\n";
+
+    my_std::concurrent_vector<long> vec_copy(vec);
+    print_header("concurrent_vector(const concurrent_vector &that)");
+    std::cout << "equal to the original: " << std::equal(vec.begin(), vec.end(), vec_copy.begin()) << "\n";
+
+    vec.clear();
+    print_header("clear()");
+    std::cout << "size = " << vec.size() << "\n";
+
+    print_header("push_back(...) when the segment allocation fails");
+    my_std::concurrent_vector<std::string, failing_allocator<std::string>, 4> strings;
+    failing_allocator<std::string>::allocations_left = 1;
+    for (int i = 0; i < 4; ++i)
+        strings.push_back(std::string(20, 'a' + i));
+
+    try
+    {
+        strings.push_back("lost");
+    }
+    catch (const std::bad_alloc &)
+    {
+        std::cout << "bad_alloc, size = " << strings.size() << "\n";
+    }
+
+    failing_allocator<std::string>::allocations_left = -1;
+    strings.push_back(std::string(20, 'e'));
+    std::cout << "after a retry: size = " << strings.size() << ", back = " << strings[strings.size() - 1] << "\n";
+}
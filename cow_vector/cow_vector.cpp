@@ -0,0 +1,105 @@
+#include "cow_vector.hpp"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+
+//==================================================================================================
+
+static const int worker_count = 8;
+
+static void print_header(const char *header)
+{
+    std::cout <<
+        "----------------------\n" <<
+        header << '\n' <<
+        "----------------------\n";
+}
+
+template <class Vector>
+static void print_elements(const Vector &vec)
+{
+    std::cout << "size = " << vec.size() << ", use_count = " << vec.use_count() << " {";
+    for (const auto &elem : vec)
+        std::cout << " " << elem;
+    std::cout << " }\n";
+}
+
+int main()
+{
+    my_std::cow_vector<int> table{0, 1, 2, 3, 4, 5, 6, 7};
+
+    print_header("copies share the buffer");
+    my_std::cow_vector<int> snapshot(table);
+    std::cout << "same data: " << (std::as_const(snapshot).data() == std::as_const(table).data()) << "\n";
+    print_elements(snapshot);
+
+    print_header("snapshot[3] = 30: the snapshot detaches, table is intact");
+    snapshot[3] = 30;
+    std::cout << "same data: " << (std::as_const(snapshot).data() == std::as_const(table).data()) << "\n";
+    print_elements(snapshot);
+    print_elements(table);
+
+    print_header("unique vector mutates in place");
+    const int *before = std::as_const(table).data();
+    table[0] = -1;
+    std::cout << "same data: " << (std::as_const(table).data() == before) << "\n";
+    print_elements(table);
+
+    print_header("push_back(table[7]), erase(begin()), insert(cbegin(), copy[0]) on a copy");
+    my_std::cow_vector<int> copy = table;
+    copy.push_back(std::as_const(table)[7]);
+    copy.erase(copy.begin());
+    copy.insert(copy.cbegin(), std::as_const(copy)[0]);
+    print_elements(copy);
+    print_elements(table);
+
+    print_header("push_back(strings[0]) right after the detach and on a full unique buffer");
+    my_std::cow_vector<std::string> strings{std::string(20, 'a')};
+    my_std::cow_vector<std::string> shared(strings);
+    strings.push_back(strings[0]);
+    while (strings.size() < strings.capacity())
+        strings.push_back(std::string(20, 'b'));
+    strings.push_back(strings[0]);
+    std::cout << "back = " << strings.back() << "\n";
+    print_elements(shared);
+
+    print_header("clear() of a shared vector drops the buffer");
+    copy = table;
+    copy.clear();
+    print_elements(copy);
+    print_elements(table);
+
+    print_header("snapshots handed to workers");
+    my_std::cow_vector<std::string> routes{"10.0.0.0/8", "172.16.0.0/12", "192.168.0.0/16"};
+    size_t lengths[worker_count] = {};
+    {
+        std::thread workers[worker_count];
+        for (int id = 0; id < worker_count; ++id)
+        {
+            workers[id] = std::thread([snapshot = routes, &length = lengths[id], id]() mutable
+            {
+                for (const std::string &route : std::as_const(snapshot))
+                    length += route.size();
+
+                // one worker in four edits its copy
+                if (id % 4 == 0)
+                {
+                    snapshot.push_back("0.0.0.0/0");
+                    length += snapshot.back().size();
+                }
+            });
+        }
+        for (std::thread &worker : workers)
+            worker.join();
+    }
+    for (int id = 0; id < worker_count; ++id)
+        std::cout << "worker " << id << ": " << lengths[id] << "\n";
+    print_elements(routes);
+
+    print_header("adopt a vector");
+    my_std::vector<int> source{1, 2, 3};
+    my_std::cow_vector<int> adopted(std::move(source));
+    std::cout << "source empty: " << source.empty() << ", equal to copy: " << (adopted == my_std::cow_vector<int>(adopted)) << "\n";
+    print_elements(adopted);
+}
@@ -0,0 +1,94 @@
+#include "flat_map.hpp"
+#include <iostream>
+#include <random>
+#include <string>
+
+//==================================================================================================
+
+static void print_header(const char *header)
+{
+    std::cout <<
+        "----------------------\n" <<
+        header << '\n' <<
+        "----------------------\n";
+}
+
+int main()
+{
+    print_header("flat_set: insert range with duplicates");
+    my_std::flat_set<int> set{5, 1, 9, 1, 3};
+    set.insert({4, 9, 2, 8, 2});
+    std::cout << set;
+
+    print_header("flat_set: single insert, erase, lookups");
+    std::cout << "insert(6): " << set.insert(6).second << ", insert(6): " << set.insert(6).second << "\n";
+    std::cout << "erase(1): " << set.erase(1) << ", erase(7): " << set.erase(7) << "\n";
+    std::cout << "lower_bound(7) = " << *set.lower_bound(7) << ", upper_bound(8) = " << *set.upper_bound(8) <<
+                 ", contains(3) = " << set.contains(3) << ", contains(7) = " << set.contains(7) << "\n";
+    std::cout << set;
+
+    print_header("flat_set: adopt a sorted vector");
+    my_std::vector<int> sorted{10, 20, 30, 40};
+    const int *keys = sorted.data();
+    my_std::flat_set<int> adopted(my_std::sorted_unique, std::move(sorted));
+    std::cout << "same data: " << (adopted.begin() == keys) << "\n";
+    std::cout << adopted;
+
+    print_header("flat_set: branchless search agrees with std::lower_bound");
+    {
+        std::mt19937 gen(42);
+        my_std::vector<int> random;
+        for (int i = 0; i < 1000; ++i)
+            random.push_back(gen() % 2000);
+
+        my_std::flat_set<int> big(std::move(random));
+
+        int mismatches = 0;
+        for (int key = -1; key <= 2001; ++key)
+        {
+            mismatches += big.lower_bound(key) != std::lower_bound(big.begin(), big.end(), key);
+            mismatches += big.upper_bound(key) != std::upper_bound(big.begin(), big.end(), key);
+        }
+        std::cout << "size = " << big.size() << ", mismatches = " << mismatches << "\n";
+    }
+
+    print_header("flat_map: insert range, the first of the equal keys wins");
+    my_std::flat_map<std::string, int> map{{"beta", 2}, {"alpha", 1}, {"delta", 4}};
+    std::pair<std::string, int> batch[] = {{"gamma", 3}, {"alpha", 100}, {"epsilon", 5}, {"gamma", 300}};
+    map.insert(std::begin(batch), std::end(batch));
+    std::cout << map;
+
+    print_header("flat_map: operator[], at, insert_or_assign, try_emplace, erase");
+    map["zeta"] = 6;
+    map["beta"] += 20;
+    map.insert_or_assign("alpha", 11);
+    std::cout << "try_emplace(\"delta\", 0): " << map.try_emplace("delta", 0).second <<
+                 ", at(\"delta\") = " << map.at("delta") << "\n";
+    std::cout << "erase(\"epsilon\"): " << map.erase("epsilon") << "\n";
+
+    try
+    {
+        map.at("omega");
+    }
+    catch (const std::out_of_range &exception)
+    {
+        std::cout << "at(\"omega\"): " << exception.what() << "\n";
+    }
+
+    for (auto it = map.begin(); it != map.end(); ++it)
+        it->second *= 10;
+    for (auto [key, value] : map)
+        std::cout << key << " -> " << value << "\n";
+
+    print_header("flat_map: adopt sorted columns, find");
+    my_std::vector<int>         ids  {1, 4, 9, 16};
+    my_std::vector<std::string> names{"one", "four", "nine", "sixteen"};
+    my_std::flat_map<int, std::string> squares(my_std::sorted_unique, std::move(ids), std::move(names));
+    std::cout << "find(9): " << squares.find(9)->second << ", find(5) == end(): " << (squares.find(5) == squares.end()) << "\n";
+    std::cout << squares;
+
+    print_header("flat_map: unsorted columns with duplicates");
+    my_std::vector<int>         codes {3, 1, 3, 2};
+    my_std::vector<std::string> labels{"c", "a", "C", "b"};
+    std::cout << my_std::flat_map<int, std::string>(std::move(codes), std::move(labels));
+}
@@ -0,0 +1,394 @@
+#ifndef BIT_VECTOR_HPP
+#define BIT_VECTOR_HPP
+
+#include <bit>
+#include <cstdint>
+
+#include "vector.hpp"
+
+//==================================================================================================
+
+namespace my_std
+{
+    // Vector of bools packed 64 per word. Elements are accessed through a proxy reference, bulk
+    // queries (count, find_first, rank, select) and the bitwise operators work on whole words.
+    //
+    // The bits past size() in the last word are always zero.
+    //
+    // rank and select use a directory with the number of set bits before every superblock of 512
+    // bits. Mutations only mark it stale, the next query rebuilds it in one pass, so a batch of
+    // updates followed by queries pays for one rebuild. The rebuild writes from const member
+    // functions: concurrent queries need external synchronization.
+    template <class Allocator = std::allocator<uint64_t>>
+    class bit_vector
+    {
+    // types
+    public:
+        using value_type      = bool;
+        using allocator_type  = Allocator;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using word_type       = uint64_t;
+        using const_reference = bool;
+
+        class reference
+        {
+        // member functions
+        public:
+            reference(word_type *word, word_type mask, bool *ranks_stale):
+            word_       (word),
+            mask_       (mask),
+            ranks_stale_(ranks_stale)
+            {}
+
+            reference(const reference &that) = default;
+
+            reference &operator =(bool value)
+            {
+                if (value) *word_ |=  mask_;
+                else       *word_ &= ~mask_;
+
+                *ranks_stale_ = true;
+                return *this;
+            }
+
+            reference &operator =(const reference &that)
+            {
+                return *this = bool(that);
+            }
+
+            operator bool() const
+            {
+                return (*word_ & mask_) != 0;
+            }
+
+            bool operator ~() const
+            {
+                return !bool(*this);
+            }
+
+            void flip()
+            {
+                *word_ ^= mask_;
+                *ranks_stale_ = true;
+            }
+
+        // member data
+        private:
+            word_type *word_;
+            word_type  mask_;
+            bool      *ranks_stale_;
+        };
+
+        using iterator       = my_detail::indexed_iterator<      bit_vector, reference>;
+        using const_iterator = my_detail::indexed_iterator<const bit_vector, const_reference>;
+
+    // friends
+
+        friend std::ostream &operator <<(std::ostream &out, const bit_vector &self)
+        {
+            out << "size = " << self.size() << " { ";
+            for (size_type idx = 0; idx < self.size(); ++idx)
+                out << self[idx];
+
+            return out << " }\n";
+        }
+
+        friend bit_vector operator &(bit_vector lhs, const bit_vector &rhs) { return lhs &= rhs; }
+        friend bit_vector operator |(bit_vector lhs, const bit_vector &rhs) { return lhs |= rhs; }
+        friend bit_vector operator ^(bit_vector lhs, const bit_vector &rhs) { return lhs ^= rhs; }
+
+    // member functions
+    public:
+        explicit bit_vector(const Allocator &allocator = Allocator()):
+        words_      (allocator),
+        size_       (0),
+        ranks_      (allocator),
+        ranks_stale_(true)
+        {}
+
+        explicit bit_vector(size_type count, bool value = false, const Allocator &allocator = Allocator()):
+        words_      (word_count(count), value ? ~word_type(0) : word_type(0), allocator),
+        size_       (count),
+        ranks_      (allocator),
+        ranks_stale_(true)
+        {
+            clear_tail();
+        }
+
+        bool operator ==(const bit_vector &that) const
+        {
+            return size_ == that.size_ && std::equal(words_.begin(), words_.end(), that.words_.begin());
+        }
+
+        reference at(size_type pos)
+        {
+            assert(pos < size());
+            return reference(&words_[pos / word_bits], bit(pos), &ranks_stale_);
+        }
+
+        const_reference at(size_type pos) const
+        {
+            assert(pos < size());
+            return (words_[pos / word_bits] & bit(pos)) != 0;
+        }
+
+        inline       reference operator [](size_type pos)       { return at(pos); }
+        inline const_reference operator [](size_type pos) const { return at(pos); }
+
+        inline       reference front()       { return at(0); }
+        inline const_reference front() const { return at(0); }
+
+        inline       reference back ()       { return at(size() - 1); }
+        inline const_reference back () const { return at(size() - 1); }
+
+        // The packed bits, bit i of the vector is bit i % 64 of word i / 64.
+        std::span<const word_type> words() const
+        {
+            return std::span<const word_type>(words_.data(), words_.size());
+        }
+
+        inline iterator        begin()       { return iterator(this, 0); }
+        inline const_iterator  begin() const { return const_iterator(this, 0); }
+        inline const_iterator cbegin() const { return const_iterator(this, 0); }
+
+        inline iterator        end()       { return iterator(this, size()); }
+        inline const_iterator  end() const { return const_iterator(this, size()); }
+        inline const_iterator cend() const { return const_iterator(this, size()); }
+
+        inline bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        inline size_type size() const
+        {
+            return size_;
+        }
+
+        inline size_type capacity() const
+        {
+            return words_.capacity() * word_bits;
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            words_.reserve(word_count(new_capacity));
+        }
+
+        void clear()
+        {
+            words_.clear();
+            size_        = 0;
+            ranks_stale_ = true;
+        }
+
+        void push_back(bool value)
+        {
+            if (size_ % word_bits == 0)
+                words_.push_back(0);
+
+            if (value)
+                words_.back() |= bit(size_);
+            ++size_;
+            ranks_stale_ = true;
+        }
+
+        void pop_back()
+        {
+            assert(!empty());
+
+            --size_;
+            if (size_ % word_bits == 0)
+                words_.pop_back();
+            else
+                words_.back() &= ~bit(size_);
+            ranks_stale_ = true;
+        }
+
+        void resize(size_type count, bool value = false)
+        {
+            if (count > size_ && value && size_ % word_bits != 0)
+                words_.back() |= ~word_type(0) << (size_ % word_bits);
+
+            words_.resize(word_count(count), value ? ~word_type(0) : word_type(0));
+            size_        = count;
+            ranks_stale_ = true;
+            clear_tail();
+        }
+
+        void flip(size_type pos)
+        {
+            at(pos).flip();
+        }
+
+        void flip()
+        {
+            for (word_type &word : words_)
+                word = ~word;
+
+            ranks_stale_ = true;
+            clear_tail();
+        }
+
+        // Number of set bits.
+        size_type count() const
+        {
+            return my_detail::simd::popcount(words_.data(), words_.size());
+        }
+
+        // Position of the first set bit, size() if there is none.
+        size_type find_first() const
+        {
+            return find_from_word(0);
+        }
+
+        // Position of the first set bit after pos, size() if there is none.
+        size_type find_next(size_type pos) const
+        {
+            ++pos;
+            if (pos >= size_)
+                return size_;
+
+            word_type word = words_[pos / word_bits] & (~word_type(0) << (pos % word_bits));
+            if (word != 0)
+                return pos / word_bits * word_bits + std::countr_zero(word);
+
+            return find_from_word(pos / word_bits + 1);
+        }
+
+        // Number of set bits in [0, pos). O(1): the directory entry of the superblock plus at
+        // most superblock_words words.
+        size_type rank(size_type pos) const
+        {
+            assert(pos <= size());
+
+            update_ranks();
+
+            size_type word_idx  = pos / word_bits;
+            size_type first_idx = word_idx / superblock_words * superblock_words;
+
+            size_type ones = ranks_[first_idx / superblock_words];
+            for (size_type idx = first_idx; idx < word_idx; ++idx)
+                ones += std::popcount(words_[idx]);
+            if (pos % word_bits != 0)
+                ones += std::popcount(words_[word_idx] & (bit(pos) - 1));
+
+            return ones;
+        }
+
+        // Position of the set bit with rank k (counting from 0), size() if there are not so many.
+        // Binary search over the superblocks, then a scan of the words of one superblock.
+        size_type select(size_type k) const
+        {
+            update_ranks();
+
+            if (k >= ranks_.back())
+                return size_;
+
+            // the last superblock which starts with at most k set bits before it
+            size_type superblock = std::upper_bound(ranks_.begin(), ranks_.end(), k) - ranks_.begin() - 1;
+            k -= ranks_[superblock];
+
+            for (size_type word_idx = superblock * superblock_words; ; ++word_idx)
+            {
+                word_type word = words_[word_idx];
+                size_type ones = std::popcount(word);
+
+                if (k < ones)
+                {
+                    for (; k > 0; --k)
+                        word &= word - 1;
+
+                    return word_idx * word_bits + std::countr_zero(word);
+                }
+                k -= ones;
+            }
+        }
+
+        bit_vector &operator &=(const bit_vector &that) { return apply(that, [](word_type lhs, word_type rhs) { return lhs & rhs; }); }
+        bit_vector &operator |=(const bit_vector &that) { return apply(that, [](word_type lhs, word_type rhs) { return lhs | rhs; }); }
+        bit_vector &operator ^=(const bit_vector &that) { return apply(that, [](word_type lhs, word_type rhs) { return lhs ^ rhs; }); }
+
+    private:
+        size_type find_from_word(size_type word_idx) const
+        {
+            for (; word_idx < words_.size(); ++word_idx)
+                if (words_[word_idx] != 0)
+                    return word_idx * word_bits + std::countr_zero(words_[word_idx]);
+
+            return size_;
+        }
+
+        template <class Op>
+        bit_vector &apply(const bit_vector &that, Op op)
+        {
+            assert(size_ == that.size_);
+
+            word_type       *dst = words_.data();
+            const word_type *src = that.words_.data();
+
+            for (size_type idx = 0; idx < words_.size(); ++idx)
+                dst[idx] = op(dst[idx], src[idx]);
+
+            ranks_stale_ = true;
+            return *this;
+        }
+
+        // ranks_[i] is the number of set bits in the superblocks before i, ranks_.back() in all of them.
+        void update_ranks() const
+        {
+            if (!ranks_stale_)
+                return;
+
+            size_type superblock_count = (words_.size() + superblock_words - 1) / superblock_words;
+            ranks_.resize(superblock_count + 1);
+
+            size_type ones = 0;
+            for (size_type superblock = 0; superblock < superblock_count; ++superblock)
+            {
+                ranks_[superblock] = ones;
+
+                size_type first = superblock * superblock_words;
+                ones += my_detail::simd::popcount(words_.data() + first, std::min(superblock_words, words_.size() - first));
+            }
+            ranks_[superblock_count] = ones;
+
+            ranks_stale_ = false;
+        }
+
+        void clear_tail()
+        {
+            if (size_ % word_bits != 0)
+                words_.back() &= bit(size_) - 1;
+        }
+
+    // static functions
+    private:
+        static word_type bit(size_type pos)
+        {
+            return word_type(1) << (pos % word_bits);
+        }
+
+        static size_type word_count(size_type bits)
+        {
+            return (bits + word_bits - 1) / word_bits;
+        }
+
+    // static data
+    private:
+        static constexpr size_type word_bits        = 64;
+        static constexpr size_type superblock_words = 8;
+
+    // member data
+    private:
+        vector<word_type, Allocator> words_;
+        size_type                    size_;
+
+        // rank directory, see update_ranks()
+        mutable vector<word_type, Allocator> ranks_;
+        mutable bool                         ranks_stale_;
+    };
+}
+
+#endif // BIT_VECTOR_HPP
@@ -0,0 +1,599 @@
+#ifndef COMPACT_VECTOR_HPP
+#define COMPACT_VECTOR_HPP
+
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+#include "vector.hpp"
+
+//==================================================================================================
+
+namespace my_std
+{
+    // Vector of the size of one pointer, for huge numbers of tiny vectors. The 32-bit size and
+    // capacity are stored in a header right before the elements in the heap block, so an empty
+    // vector is a null pointer and the elements are still one indexing away. The interface follows
+    // vector, with at most 2^32 - 1 elements.
+    template <class T, class Allocator = std::allocator<T>, class GrowthPolicy = growth_x2>
+    class compact_vector
+    {
+    // types
+    public:
+        using value_type      = T;
+        using allocator_type  = Allocator;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+        using pointer         = value_type*;
+        using const_pointer   = const value_type*;
+        using iterator        = pointer;
+        using const_iterator  = const_pointer;
+
+    // friends
+
+        friend std::ostream &operator <<(std::ostream &out, const compact_vector &self)
+        {
+            out <<
+                "compact_vector (" << &self << ")\n" <<
+                "\tsize     = " << self.size()     << "\n" <<
+                "\tcapacity = " << self.capacity() << "\n";
+
+            for (size_type idx = 0; idx < self.size(); ++idx)
+                out << "\n# " << idx << "\n" << self[idx];
+
+            return out;
+        }
+
+    // member functions
+    public:
+        compact_vector():
+        allocator_(),
+        data_     (nullptr)
+        {}
+
+        explicit compact_vector(const Allocator &allocator):
+        allocator_(allocator),
+        data_     (nullptr)
+        {}
+
+        explicit compact_vector(size_type count, const_reference value, const Allocator &allocator = Allocator()):
+        compact_vector(allocator)
+        {
+            assign(count, value);
+        }
+
+        explicit compact_vector(size_type count, const Allocator &allocator = Allocator()):
+        compact_vector(allocator)
+        {
+            resize(count);
+        }
+
+        template <class InputIt, class = std::enable_if_t<
+            std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>>>
+        explicit compact_vector(InputIt first, InputIt last, const Allocator &allocator = Allocator()):
+        compact_vector(allocator)
+        {
+            assign(first, last);
+        }
+
+        compact_vector(std::initializer_list<T> init_list, const Allocator &allocator = Allocator()):
+        compact_vector(allocator)
+        {
+            assign(init_list.begin(), init_list.end());
+        }
+
+        compact_vector(const compact_vector &that):
+        compact_vector(std::allocator_traits<Allocator>::select_on_container_copy_construction(that.allocator_))
+        {
+            assign(that.begin(), that.end());
+        }
+
+        compact_vector(compact_vector &&that):
+        allocator_(std::move(that.allocator_)),
+        data_     (that.data_)
+        {
+            that.data_ = nullptr;
+        }
+
+        ~compact_vector()
+        {
+            clear();
+            deallocate_block(data_);
+        }
+
+        compact_vector &operator =(const compact_vector &that)
+        {
+            if (this == &that)
+                return *this;
+
+            if constexpr (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value)
+            {
+                if (allocator_ != that.allocator_)
+                {
+                    clear();
+                    deallocate_block(data_);
+                    data_ = nullptr;
+                }
+                allocator_ = that.allocator_;
+            }
+
+            assign(that.begin(), that.end());
+            return *this;
+        }
+
+        compact_vector &operator =(compact_vector &&that)
+        {
+            if (this == &that)
+                return *this;
+
+            constexpr bool propagate = std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value;
+
+            if (propagate || allocator_ == that.allocator_)
+            {
+                clear();
+                deallocate_block(data_);
+
+                if constexpr (propagate)
+                    allocator_ = std::move(that.allocator_);
+
+                data_      = that.data_;
+                that.data_ = nullptr;
+            }
+            else
+                assign(std::make_move_iterator(that.begin()), std::make_move_iterator(that.end()));
+
+            return *this;
+        }
+
+        compact_vector &operator =(std::initializer_list<T> init_list)
+        {
+            assign(init_list.begin(), init_list.end());
+            return *this;
+        }
+
+        void assign(size_type count, const_reference value)
+        {
+            clear();
+            insert(end(), count, value);
+        }
+
+        template <class InputIt, class = std::enable_if_t<
+            std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>>>
+        void assign(InputIt first, InputIt last)
+        {
+            clear();
+            insert(end(), first, last);
+        }
+
+        inline allocator_type get_allocator() const
+        {
+            return allocator_;
+        }
+
+        reference at(size_type pos)
+        {
+            assert(pos < size());
+            return data_[pos];
+        }
+
+        const_reference at(size_type pos) const
+        {
+            assert(pos < size());
+            return data_[pos];
+        }
+
+        inline       reference operator [](size_type pos)       { return at(pos); }
+        inline const_reference operator [](size_type pos) const { return at(pos); }
+
+        inline       reference front()       { return at(0); }
+        inline const_reference front() const { return at(0); }
+
+        inline       reference back ()       { return at(size() - 1); }
+        inline const_reference back () const { return at(size() - 1); }
+
+        inline       T *data()       { return data_; }
+        inline const T *data() const { return data_; }
+
+        inline iterator        begin()       { return data_; }
+        inline const_iterator  begin() const { return data_; }
+        inline const_iterator cbegin() const { return data_; }
+
+        inline iterator        end()       { return data_ + size(); }
+        inline const_iterator  end() const { return data_ + size(); }
+        inline const_iterator cend() const { return data_ + size(); }
+
+        inline bool empty() const
+        {
+            return size() == 0;
+        }
+
+        inline size_type size() const
+        {
+            return data_ ? header(data_)->size : 0;
+        }
+
+        inline size_type capacity() const
+        {
+            return data_ ? header(data_)->capacity : 0;
+        }
+
+        static constexpr size_type max_size()
+        {
+            return std::numeric_limits<uint32_t>::max();
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            if (new_capacity > max_size())
+                throw std::length_error("compact_vector::reserve: capacity exceeds max_size()");
+
+            if (new_capacity > capacity())
+                realloc(std::min(GrowthPolicy::fit(new_capacity, sizeof(T)), max_size()));
+        }
+
+        void shrink_to_fit()
+        {
+            if (capacity() == size())
+                return;
+
+            if (empty())
+            {
+                deallocate_block(data_);
+                data_ = nullptr;
+                return;
+            }
+            realloc(size());
+        }
+
+        void clear()
+        {
+            if (!data_)
+                return;
+
+            my_detail::destroy_n(allocator_, data_, size());
+            set_size(0);
+        }
+
+        iterator insert(const_iterator pos, const_reference value)
+        {
+            return insert(pos, 1, value);
+        }
+
+        iterator insert(const_iterator pos, T &&value)
+        {
+            return open_gap(pos - begin(), 1, [this, &value](T *gap)
+            {
+                std::allocator_traits<Allocator>::construct(allocator_, gap, std::move(value));
+            });
+        }
+
+        iterator insert(const_iterator pos, size_type count, const_reference value)
+        {
+            if (count == 0)
+                return const_cast<iterator>(pos);
+
+            // an element would be shifted before it is copied
+            if (&value >= begin() && &value < end())
+            {
+                value_type copy(value);
+                return insert(pos, count, copy);
+            }
+
+            return open_gap(pos - begin(), count, [this, count, &value](T *gap)
+            {
+                T *cur = gap;
+                try
+                {
+                    for (; cur != gap + count; ++cur)
+                        std::allocator_traits<Allocator>::construct(allocator_, cur, value);
+                }
+                catch (...)
+                {
+                    my_detail::destroy_n(allocator_, gap, cur - gap);
+                    throw;
+                }
+            });
+        }
+
+        template <class InputIt, class = std::enable_if_t<
+            std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>>>
+        iterator insert(const_iterator pos, InputIt first, InputIt last)
+        {
+            size_type offset = pos - begin();
+
+            if constexpr (!std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+            {
+                size_type old_size = size();
+                for (; first != last; ++first)
+                    emplace_back(*first);
+
+                std::rotate(begin() + offset, begin() + old_size, end());
+                return begin() + offset;
+            }
+            else
+            {
+                size_type count = std::distance(first, last);
+                if (count == 0)
+                    return begin() + offset;
+
+                return open_gap(offset, count, [this, first, count](T *gap)
+                {
+                    T *cur = gap;
+                    try
+                    {
+                        for (InputIt it = first; cur != gap + count; ++it, ++cur)
+                            std::allocator_traits<Allocator>::construct(allocator_, cur, *it);
+                    }
+                    catch (...)
+                    {
+                        my_detail::destroy_n(allocator_, gap, cur - gap);
+                        throw;
+                    }
+                });
+            }
+        }
+
+        inline iterator insert(const_iterator pos, std::initializer_list<T> init_list)
+        {
+            return insert(pos, init_list.begin(), init_list.end());
+        }
+
+        template <class... Args>
+        iterator emplace(const_iterator pos, Args&&... args)
+        {
+            if (pos != end())
+            {
+                // args may refer to elements which are shifted before the construction
+                return insert(pos, value_type(std::forward<Args>(args)...));
+            }
+
+            // on growth the new element is built before the old block is freed
+            return open_gap(size(), 1, [this, &args...](T *gap)
+            {
+                std::allocator_traits<Allocator>::construct(allocator_, gap, std::forward<Args>(args)...);
+            });
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            assert(pos >= begin());
+            assert(pos < end());
+
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            iterator gap_begin = const_cast<iterator>(first);
+            iterator gap_end   = const_cast<iterator>(last);
+
+            if (gap_begin == gap_end)
+                return gap_begin;
+
+            assert(begin() <= gap_begin);
+            assert(gap_begin < gap_end);
+            assert(gap_end <= end());
+
+            size_type new_size = size() - (gap_end - gap_begin);
+
+            my_detail::destroy_n(allocator_, gap_begin, gap_end - gap_begin);
+            my_detail::relocate_down(allocator_, gap_begin, gap_end, end() - gap_end);
+            set_size(new_size);
+
+            return gap_begin;
+        }
+
+        void push_back(const_reference value)
+        {
+            emplace_back(value);
+        }
+
+        void push_back(T &&value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        template <class... Args>
+        reference emplace_back(Args&&... args)
+        {
+            if (size() < capacity())
+            {
+                std::allocator_traits<Allocator>::construct(allocator_, end(), std::forward<Args>(args)...);
+                set_size(size() + 1);
+                return back();
+            }
+            return *emplace(end(), std::forward<Args>(args)...);
+        }
+
+        void pop_back()
+        {
+            assert(!empty());
+
+            std::allocator_traits<Allocator>::destroy(allocator_, end() - 1);
+            set_size(size() - 1);
+        }
+
+        void resize(size_type count)
+        {
+            resize(count, T());
+        }
+
+        void resize(size_type count, const_reference value)
+        {
+            if (count < size())
+            {
+                my_detail::destroy_n(allocator_, data_ + count, size() - count);
+                set_size(count);
+            }
+            else if (count > size())
+                insert(end(), count - size(), value);
+        }
+
+        void swap(compact_vector &that)
+        {
+            if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value)
+                std::swap(allocator_, that.allocator_);
+            else
+                assert(allocator_ == that.allocator_);
+
+            std::swap(data_, that.data_);
+        }
+
+        bool operator ==(const compact_vector &that) const
+        {
+            return std::equal(begin(), end(), that.begin(), that.end());
+        }
+
+    private:
+        struct header_t
+        {
+            uint32_t size;
+            uint32_t capacity;
+        };
+
+        using byte_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::byte>;
+
+        static constexpr size_t header_size = (sizeof(header_t) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+        static header_t *header(const T *data)
+        {
+            return reinterpret_cast<header_t *>(reinterpret_cast<std::byte *>(const_cast<T *>(data)) - header_size);
+        }
+
+        // Without a block there is no header, the size is 0.
+        void set_size(size_type new_size)
+        {
+            if (!data_)
+            {
+                assert(new_size == 0);
+                return;
+            }
+
+            header(data_)->size = static_cast<uint32_t>(new_size);
+        }
+
+        // Returns the elements of a new block with the given capacity and no elements.
+        T *allocate_block(size_type capacity)
+        {
+            assert(capacity <= max_size());
+
+            byte_allocator allocator(allocator_);
+            std::byte *block = std::allocator_traits<byte_allocator>::allocate(allocator, header_size + capacity * sizeof(T));
+
+            T *data = reinterpret_cast<T *>(block + header_size);
+            *header(data) = {0, static_cast<uint32_t>(capacity)};
+
+            return data;
+        }
+
+        void deallocate_block(T *data)
+        {
+            if (!data)
+                return;
+
+            byte_allocator allocator(allocator_);
+            std::allocator_traits<byte_allocator>::deallocate(allocator, reinterpret_cast<std::byte *>(header(data)),
+                                                              header_size + header(data)->capacity * sizeof(T));
+        }
+
+        void realloc(size_type new_capacity)
+        {
+            size_type old_size = size();
+            T        *new_data = allocate_block(new_capacity);
+
+            my_detail::relocate_n(allocator_, new_data, data_, old_size);
+            deallocate_block(data_);
+
+            data_ = new_data;
+            set_size(old_size);
+        }
+
+        // Opens a gap of count uninitialized slots at offset and fills it with fill(gap). When the
+        // block is too small, the new one is assembled as prefix + inserted + suffix. fill(gap)
+        // destroys what it built when it throws; the shifted tail is then moved back over the gap.
+        template <class Filler>
+        iterator open_gap(size_type offset, size_type count, Filler fill)
+        {
+            size_type old_size = size();
+            size_type new_size = old_size + count;
+
+            assert(offset <= old_size);
+            assert(new_size <= max_size());
+
+            if (new_size > capacity())
+            {
+                size_type new_capacity = std::min(GrowthPolicy::grow(capacity(), new_size, sizeof(T)), max_size());
+                T        *new_data     = allocate_block(new_capacity);
+
+                // inserted elements go first: they may be built from the old elements
+                try
+                {
+                    fill(new_data + offset);
+                }
+                catch (...)
+                {
+                    deallocate_block(new_data);
+                    throw;
+                }
+
+                if (data_)
+                {
+                    my_detail::relocate_n(allocator_, new_data, data_, offset);
+                    my_detail::relocate_n(allocator_, new_data + offset + count, data_ + offset, old_size - offset);
+                    deallocate_block(data_);
+                }
+
+                data_ = new_data;
+                set_size(new_size);
+                return data_ + offset;
+            }
+
+            T *gap = data_ + offset;
+
+            if constexpr (relocatable)
+            {
+                std::memmove(static_cast<void *>(gap + count), gap, (old_size - offset) * sizeof(T));
+            }
+            else
+            {
+                size_type moved = std::min(count, old_size - offset);
+                T        *last  = data_ + old_size;
+
+                for (T *src = last - moved, *dst = last + count - moved; src != last; ++src, ++dst)
+                    std::allocator_traits<Allocator>::construct(allocator_, dst, std::move(*src));
+                std::move_backward(gap, last - moved, last);
+                my_detail::destroy_n(allocator_, gap, moved);
+            }
+
+            try
+            {
+                fill(gap);
+            }
+            catch (...)
+            {
+                my_detail::relocate_down(allocator_, gap, gap + count, old_size - offset);
+                throw;
+            }
+
+            set_size(new_size);
+            return gap;
+        }
+
+    // static data
+    private:
+        static constexpr bool relocatable = my_detail::is_relocatable_by_memcpy_v<T, Allocator>;
+
+    // member data
+    private:
+        [[no_unique_address]] Allocator allocator_;
+
+        T *data_;
+    };
+}
+
+#endif // COMPACT_VECTOR_HPP
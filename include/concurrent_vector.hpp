@@ -0,0 +1,233 @@
+#ifndef CONCURRENT_VECTOR_HPP
+#define CONCURRENT_VECTOR_HPP
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <exception>
+#include <iterator>
+#include <memory>
+
+#include "vector.hpp"
+
+//==================================================================================================
+
+namespace my_std
+{
+    // Vector which supports push_back/emplace_back from many threads at once without a lock.
+    //
+    // Elements live in segments of growing power of two sizes (FirstSegmentSize, 2 * FirstSegmentSize,
+    // 4 * FirstSegmentSize, ...), which are never moved, so element addresses are stable. An append
+    // first makes sure the segment of the next index exists (a missing one is published with a
+    // compare-and-swap), then claims that index with a compare-and-swap on the size. If the segment
+    // allocation throws, no index has been claimed and the vector is unchanged.
+    //
+    // size() counts claimed indices: an element pushed by another thread may still be under
+    // construction, it may be read after the synchronization with that thread. The element
+    // constructors must not throw inside concurrent appends (an exception terminates the program).
+    // Destruction, reserve(), clear() and assignment must not run concurrently with anything else.
+    template <class T, class Allocator = std::allocator<T>, size_t FirstSegmentSize = 64>
+    class concurrent_vector
+    {
+    // assert
+        static_assert(FirstSegmentSize != 0 && (FirstSegmentSize & (FirstSegmentSize - 1)) == 0);
+
+    // types
+    public:
+        using value_type      = T;
+        using allocator_type  = Allocator;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+
+        using iterator       = my_detail::indexed_iterator<      concurrent_vector,       T&>;
+        using const_iterator = my_detail::indexed_iterator<const concurrent_vector, const T&>;
+
+    // member functions
+    public:
+        explicit concurrent_vector(const Allocator &allocator = Allocator()):
+        allocator_(allocator),
+        size_     (0)
+        {
+            for (std::atomic<T *> &segment : segments_)
+                segment.store(nullptr, std::memory_order_relaxed);
+        }
+
+        concurrent_vector(const concurrent_vector &that):
+        concurrent_vector(std::allocator_traits<Allocator>::select_on_container_copy_construction(that.allocator_))
+        {
+            reserve(that.size());
+            for (const T &elem : that)
+                push_back(elem);
+        }
+
+        concurrent_vector &operator =(const concurrent_vector &that) = delete;
+
+        ~concurrent_vector()
+        {
+            clear();
+
+            for (size_type segment = 0; segment < max_segment_count; ++segment)
+            {
+                T *data = segments_[segment].load(std::memory_order_relaxed);
+                if (data)
+                    std::allocator_traits<Allocator>::deallocate(allocator_, data, segment_size(segment));
+            }
+        }
+
+        reference operator [](size_type pos)
+        {
+            return slot(pos);
+        }
+
+        const_reference operator [](size_type pos) const
+        {
+            return const_cast<concurrent_vector *>(this)->slot(pos);
+        }
+
+        reference at(size_type pos)
+        {
+            assert(pos < size());
+            return slot(pos);
+        }
+
+        const_reference at(size_type pos) const
+        {
+            assert(pos < size());
+            return (*this)[pos];
+        }
+
+        inline iterator        begin()       { return iterator(this, 0); }
+        inline const_iterator  begin() const { return const_iterator(this, 0); }
+        inline const_iterator cbegin() const { return const_iterator(this, 0); }
+
+        inline iterator        end()       { return iterator(this, size()); }
+        inline const_iterator  end() const { return const_iterator(this, size()); }
+        inline const_iterator cend() const { return const_iterator(this, size()); }
+
+        inline bool empty() const
+        {
+            return size() == 0;
+        }
+
+        inline size_type size() const
+        {
+            return size_.load(std::memory_order_acquire);
+        }
+
+        // Allocates the segments for new_capacity elements in advance.
+        void reserve(size_type new_capacity)
+        {
+            if (new_capacity == 0)
+                return;
+
+            size_type last_segment = segment_of(new_capacity - 1);
+            for (size_type segment = 0; segment <= last_segment; ++segment)
+                ensure_segment(segment);
+        }
+
+        // Destroys the elements, the segments are kept.
+        void clear()
+        {
+            size_type count = size_.load(std::memory_order_relaxed);
+            for (size_type idx = 0; idx < count; ++idx)
+                std::allocator_traits<Allocator>::destroy(allocator_, &slot(idx));
+
+            size_.store(0, std::memory_order_release);
+        }
+
+        // Thread safe. Returns the index of the new element.
+        size_type push_back(const_reference value)
+        {
+            return emplace_back(value);
+        }
+
+        size_type push_back(T &&value)
+        {
+            return emplace_back(std::move(value));
+        }
+
+        template <class... Args>
+        size_type emplace_back(Args&&... args)
+        {
+            size_type idx  = size_.load(std::memory_order_relaxed);
+            T        *data = nullptr;
+
+            // a failed compare-and-swap reloads idx, the next one may need another segment
+            do
+            {
+                data = ensure_segment(segment_of(idx));
+            }
+            while (!size_.compare_exchange_weak(idx, idx + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+            construct(&data[offset_in_segment(idx)], std::forward<Args>(args)...);
+            return idx;
+        }
+
+    private:
+        T &slot(size_type idx) const
+        {
+            T *data = segments_[segment_of(idx)].load(std::memory_order_acquire);
+            assert(data);
+
+            return data[offset_in_segment(idx)];
+        }
+
+        // Returns the segment, allocating it if no other thread has done it yet.
+        T *ensure_segment(size_type segment)
+        {
+            T *data = segments_[segment].load(std::memory_order_acquire);
+            if (data)
+                return data;
+
+            T *new_data = std::allocator_traits<Allocator>::allocate(allocator_, segment_size(segment));
+            if (segments_[segment].compare_exchange_strong(data, new_data, std::memory_order_acq_rel))
+                return new_data;
+
+            // another thread has won, data holds its segment
+            std::allocator_traits<Allocator>::deallocate(allocator_, new_data, segment_size(segment));
+            return data;
+        }
+
+        template <class... Args>
+        void construct(T *elem, Args&&... args) noexcept
+        {
+            std::allocator_traits<Allocator>::construct(allocator_, elem, std::forward<Args>(args)...);
+        }
+
+    // static functions
+    private:
+        // Segment k covers [FirstSegmentSize * (2^k - 1), FirstSegmentSize * (2^(k + 1) - 1)),
+        // so the highest bit of idx + FirstSegmentSize tells the segment.
+        static size_type segment_of(size_type idx)
+        {
+            return std::bit_width(idx + FirstSegmentSize) - first_segment_log - 1;
+        }
+
+        static size_type offset_in_segment(size_type idx)
+        {
+            size_type shifted = idx + FirstSegmentSize;
+            return shifted - (size_type(1) << (std::bit_width(shifted) - 1));
+        }
+
+        static size_type segment_size(size_type segment)
+        {
+            return FirstSegmentSize << segment;
+        }
+
+    // static data
+    private:
+        static constexpr size_type first_segment_log = std::bit_width(FirstSegmentSize) - 1;
+        static constexpr size_type max_segment_count = 8 * sizeof(size_type) - first_segment_log;
+
+    // member data
+    private:
+        Allocator allocator_;
+
+        alignas(64) std::atomic<size_type> size_;
+        alignas(64) std::atomic<T *>       segments_[max_segment_count];
+    };
+}
+
+#endif // CONCURRENT_VECTOR_HPP
@@ -0,0 +1,267 @@
+#ifndef COW_VECTOR_HPP
+#define COW_VECTOR_HPP
+
+#include <utility>
+
+#include "shared_ptr.hpp"
+#include "vector.hpp"
+
+//==================================================================================================
+
+namespace my_std
+{
+    // Copy-on-write vector for read-mostly snapshots. Copies share one vector through a refcounted
+    // shared_ptr, so a copy costs one atomic increment. The first mutating access of a shared copy
+    // (every non-const member, including non-const operator[], begin() and data()) copies the
+    // elements into a buffer of its own; the other copies are not affected.
+    //
+    // Copies may be handed to other threads and read or mutated there, one cow_vector object must
+    // not be used by several threads at once. A reference or iterator got from a non-const member
+    // must not be written through after the vector is copied.
+    template <class T, class Allocator = std::allocator<T>>
+    class cow_vector
+    {
+    // types
+    public:
+        using storage_type    = vector<T, Allocator>;
+        using value_type      = T;
+        using allocator_type  = Allocator;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+        using pointer         = value_type*;
+        using const_pointer   = const value_type*;
+        using iterator        = pointer;
+        using const_iterator  = const_pointer;
+
+    // friends
+
+        friend std::ostream &operator <<(std::ostream &out, const cow_vector &self)
+        {
+            out <<
+                "cow_vector (" << &self << ")\n" <<
+                "\tsize      = " << self.size()      << "\n" <<
+                "\tuse_count = " << self.use_count() << "\n" <<
+                "\t{\n";
+
+            for (const_reference elem : self)
+                out << "\t\t" << elem << "\n";
+
+            return out << "\t}\n";
+        }
+
+    // member functions
+    public:
+        cow_vector() = default;
+
+        explicit cow_vector(size_type count, const_reference value = T()):
+        data_(make_storage(count, value))
+        {}
+
+        cow_vector(std::initializer_list<T> init_list):
+        data_(make_storage(init_list))
+        {}
+
+        template <class InputIt>
+        requires (!std::is_integral_v<InputIt>)
+        cow_vector(InputIt first, InputIt last):
+        data_(make_storage(first, last))
+        {}
+
+        // Takes the elements of vec without copying them.
+        explicit cow_vector(storage_type &&vec):
+        data_(make_storage(std::move(vec)))
+        {}
+
+        cow_vector(const cow_vector & that) = default;
+        cow_vector(      cow_vector &&that) = default;
+
+        cow_vector &operator =(const cow_vector & that) = default;
+        cow_vector &operator =(      cow_vector &&that) = default;
+
+        void swap(cow_vector &that)
+        {
+            std::swap(data_, that.data_);
+        }
+
+        bool operator ==(const cow_vector &that) const
+        {
+            if (data() == that.data())
+                return size() == that.size();
+
+            return size() == that.size() && std::equal(begin(), end(), that.begin());
+        }
+
+        // Shares the buffer with the copies, never copies the elements.
+        const_reference at(size_type pos) const
+        {
+            assert(pos < size());
+            return data()[pos];
+        }
+
+        inline const_reference operator [](size_type pos) const { return at(pos); }
+
+        inline const_reference front() const { return at(0); }
+        inline const_reference back () const { return at(size() - 1); }
+
+        inline const T *data() const { return data_ ? data_->data() : nullptr; }
+
+        inline const_iterator  begin() const { return data(); }
+        inline const_iterator cbegin() const { return data(); }
+
+        inline const_iterator  end() const { return data() + size(); }
+        inline const_iterator cend() const { return data() + size(); }
+
+        // Copies the elements first if the buffer is shared.
+        reference at(size_type pos)
+        {
+            assert(pos < size());
+            return mutable_storage()[pos];
+        }
+
+        inline reference operator [](size_type pos) { return at(pos); }
+
+        inline reference front() { return at(0); }
+        inline reference back () { return at(size() - 1); }
+
+        inline T *data() { return empty() ? nullptr : mutable_storage().data(); }
+
+        inline iterator begin() { return data(); }
+        inline iterator end  () { return data() + size(); }
+
+        inline bool empty() const
+        {
+            return size() == 0;
+        }
+
+        inline size_type size() const
+        {
+            return data_ ? data_->size() : 0;
+        }
+
+        inline size_type capacity() const
+        {
+            return data_ ? data_->capacity() : 0;
+        }
+
+        // Number of the copies sharing the buffer, 0 for a vector without one.
+        inline size_type use_count() const
+        {
+            return data_.use_count();
+        }
+
+        // The shared vector, for the code taking vector by const reference.
+        const storage_type &storage() const
+        {
+            static const storage_type empty_storage;
+            return data_ ? *data_ : empty_storage;
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            if (new_capacity > capacity())
+                mutable_storage().reserve(new_capacity);
+        }
+
+        // Drops the reference to a shared buffer instead of copying it.
+        void clear()
+        {
+            if (data_.unique())
+                data_->clear();
+            else
+                data_ = shared_ptr<storage_type>();
+        }
+
+        void resize(size_type count)
+        {
+            if (count != size())
+                mutable_storage().resize(count);
+        }
+
+        void resize(size_type count, const_reference value)
+        {
+            if (count != size())
+                mutable_storage().resize(count, value);
+        }
+
+        void push_back(const_reference value)
+        {
+            emplace_back(value);
+        }
+
+        void push_back(value_type &&value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        // The new element goes first: args may refer to the buffer, which the other copies may free
+        // once this one has detached from it, and which the growth frees even when it is unique.
+        template <class... Args>
+        reference emplace_back(Args&&... args)
+        {
+            T elem(std::forward<Args>(args)...);
+            return mutable_storage().emplace_back(std::move(elem));
+        }
+
+        void pop_back()
+        {
+            assert(!empty());
+            mutable_storage().pop_back();
+        }
+
+        iterator insert(const_iterator pos, const_reference value)
+        {
+            size_type idx = pos - cbegin();
+            T         elem(value);
+
+            storage_type &storage = mutable_storage();
+            storage.insert(storage.begin() + idx, std::move(elem));
+            return storage.data() + idx;
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            size_type idx   = first - cbegin();
+            size_type count = last  - first;
+
+            if (count != 0)
+            {
+                storage_type &storage = mutable_storage();
+                storage.erase(storage.begin() + idx, storage.begin() + idx + count);
+            }
+            return data() + idx;
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            return erase(pos, pos + 1);
+        }
+
+    private:
+        // The vector owned by this copy alone, copied from the shared one if needed.
+        storage_type &mutable_storage()
+        {
+            if (!data_)
+                data_ = my_std::make_shared<storage_type>();
+            else if (!data_.unique())
+                data_ = my_std::make_shared<storage_type>(std::as_const(*data_));
+
+            return *data_;
+        }
+
+    // static functions
+    private:
+        template <class... Args>
+        static shared_ptr<storage_type> make_storage(Args&&... args)
+        {
+            return my_std::make_shared<storage_type>(std::forward<Args>(args)...);
+        }
+
+    // member data
+    private:
+        shared_ptr<storage_type> data_;
+    };
+}
+
+#endif // COW_VECTOR_HPP
@@ -0,0 +1,738 @@
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include <algorithm>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "vector.hpp"
+
+//==================================================================================================
+
+namespace my_std
+{
+    // Tag of the constructors and inserts taking keys which are already sorted and distinct.
+    struct sorted_unique_t
+    {
+        explicit sorted_unique_t() = default;
+    };
+
+    inline constexpr sorted_unique_t sorted_unique{};
+}
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace my_detail
+{
+    // Number of the leading elements of the array for which pred holds (pred must hold for a prefix).
+    // The range is halved with a conditional move instead of a branch, so the loop always runs
+    // log2(count) times and a lookup never pays for a mispredicted comparison.
+    template <class T, class Pred>
+    size_t branchless_partition_point(const T *data, size_t count, Pred pred)
+    {
+        if (count == 0)
+            return 0;
+
+        const T *base = data;
+        while (count > 1)
+        {
+            size_t half = count / 2;
+
+            base   = pred(base[half]) ? base + half : base;
+            count -= half;
+        }
+
+        return (base - data) + pred(*base);
+    }
+
+    template <class T, class K, class Compare>
+    size_t branchless_lower_bound(const T *data, size_t count, const K &key, const Compare &comp)
+    {
+        return branchless_partition_point(data, count, [&](const T &elem) { return comp(elem, key); });
+    }
+
+    template <class T, class K, class Compare>
+    size_t branchless_upper_bound(const T *data, size_t count, const K &key, const Compare &comp)
+    {
+        return branchless_partition_point(data, count, [&](const T &elem) { return !comp(key, elem); });
+    }
+
+    template <class T, class Compare>
+    bool is_sorted_unique(const T *data, size_t count, const Compare &comp)
+    {
+        for (size_t idx = 1; idx < count; ++idx)
+            if (!comp(data[idx - 1], data[idx])) return false;
+
+        return true;
+    }
+}
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace my_std
+{
+    // Set kept as a sorted vector of distinct keys: lookups are binary searches over one contiguous
+    // array instead of pointer chasing through tree nodes. Meant for tables built once and queried
+    // many times: a single insert shifts the tail, so bulk loads go through the range insert, which
+    // appends the keys, sorts them and merges them into the old ones in O(n log n).
+    template <class Key, class Compare = std::less<Key>, class Allocator = std::allocator<Key>>
+    class flat_set
+    {
+    // types
+    public:
+        using key_type        = Key;
+        using value_type      = Key;
+        using key_compare     = Compare;
+        using value_compare   = Compare;
+        using allocator_type  = Allocator;
+        using container_type  = vector<Key, Allocator>;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using reference       = const value_type&;
+        using const_reference = const value_type&;
+        using iterator        = const value_type*;
+        using const_iterator  = const value_type*;
+
+    // friends
+
+        friend std::ostream &operator <<(std::ostream &out, const flat_set &self)
+        {
+            out << "size = " << self.size() << " {";
+            for (const_reference key : self)
+                out << " " << key;
+
+            return out << " }\n";
+        }
+
+    // member functions
+    public:
+        flat_set():
+        keys_(),
+        comp_()
+        {}
+
+        explicit flat_set(const Compare &comp):
+        keys_(),
+        comp_(comp)
+        {}
+
+        flat_set(std::initializer_list<Key> init_list, const Compare &comp = Compare()):
+        flat_set(comp)
+        {
+            insert(init_list);
+        }
+
+        template <class InputIt>
+        flat_set(InputIt first, InputIt last, const Compare &comp = Compare()):
+        flat_set(comp)
+        {
+            insert(first, last);
+        }
+
+        // Sorts the keys in place and drops the duplicates.
+        explicit flat_set(container_type &&keys, const Compare &comp = Compare()):
+        keys_(std::move(keys)),
+        comp_(comp)
+        {
+            sort_unique(0);
+        }
+
+        // Takes the keys as they are, without copying or sorting them.
+        flat_set(sorted_unique_t, container_type &&keys, const Compare &comp = Compare()):
+        keys_(std::move(keys)),
+        comp_(comp)
+        {
+            assert(my_detail::is_sorted_unique(keys_.data(), keys_.size(), comp_));
+        }
+
+        bool operator ==(const flat_set &that) const
+        {
+            return size() == that.size() && std::equal(begin(), end(), that.begin());
+        }
+
+        // The sorted keys.
+        const container_type &keys() const
+        {
+            return keys_;
+        }
+
+        // Gives the keys away, the set is left empty.
+        container_type extract()
+        {
+            container_type keys(std::move(keys_));
+            keys_.clear();
+
+            return keys;
+        }
+
+        inline const_iterator  begin() const { return keys_.data(); }
+        inline const_iterator cbegin() const { return keys_.data(); }
+
+        inline const_iterator  end() const { return keys_.data() + keys_.size(); }
+        inline const_iterator cend() const { return keys_.data() + keys_.size(); }
+
+        inline bool empty() const
+        {
+            return keys_.empty();
+        }
+
+        inline size_type size() const
+        {
+            return keys_.size();
+        }
+
+        inline size_type capacity() const
+        {
+            return keys_.capacity();
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            keys_.reserve(new_capacity);
+        }
+
+        void clear()
+        {
+            keys_.clear();
+        }
+
+        const_iterator lower_bound(const Key &key) const
+        {
+            return begin() + my_detail::branchless_lower_bound(keys_.data(), size(), key, comp_);
+        }
+
+        const_iterator upper_bound(const Key &key) const
+        {
+            return begin() + my_detail::branchless_upper_bound(keys_.data(), size(), key, comp_);
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(const Key &key) const
+        {
+            const_iterator first = lower_bound(key);
+            return {first, first != end() && !comp_(key, *first) ? first + 1 : first};
+        }
+
+        const_iterator find(const Key &key) const
+        {
+            const_iterator pos = lower_bound(key);
+            return pos != end() && !comp_(key, *pos) ? pos : end();
+        }
+
+        bool contains(const Key &key) const
+        {
+            return find(key) != end();
+        }
+
+        size_type count(const Key &key) const
+        {
+            return contains(key) ? 1 : 0;
+        }
+
+        std::pair<iterator, bool> insert(const Key &key)
+        {
+            return emplace(key);
+        }
+
+        std::pair<iterator, bool> insert(Key &&key)
+        {
+            return emplace(std::move(key));
+        }
+
+        template <class... Args>
+        std::pair<iterator, bool> emplace(Args&&... args)
+        {
+            Key       key(std::forward<Args>(args)...);
+            size_type idx = my_detail::branchless_lower_bound(keys_.data(), size(), key, comp_);
+
+            if (idx != size() && !comp_(key, keys_[idx]))
+                return {begin() + idx, false};
+
+            keys_.insert(keys_.begin() + idx, std::move(key));
+            return {begin() + idx, true};
+        }
+
+        // Appends the keys, sorts them and merges them into the old ones. Of the equal keys the
+        // one already in the set is kept.
+        template <class InputIt>
+        void insert(InputIt first, InputIt last)
+        {
+            size_type old_size = size();
+
+            keys_.insert(keys_.end(), first, last);
+            sort_unique(old_size);
+        }
+
+        void insert(std::initializer_list<Key> init_list)
+        {
+            insert(init_list.begin(), init_list.end());
+        }
+
+        // The keys are already sorted and distinct, they are only merged.
+        template <class InputIt>
+        void insert(sorted_unique_t, InputIt first, InputIt last)
+        {
+            size_type old_size = size();
+
+            keys_.insert(keys_.end(), first, last);
+            assert(my_detail::is_sorted_unique(keys_.data() + old_size, size() - old_size, comp_));
+
+            merge_unique(old_size);
+        }
+
+        const_iterator erase(const_iterator pos)
+        {
+            return erase(pos, pos + 1);
+        }
+
+        const_iterator erase(const_iterator first, const_iterator last)
+        {
+            size_type idx = first - begin();
+
+            keys_.erase(keys_.begin() + idx, keys_.begin() + (last - begin()));
+            return begin() + idx;
+        }
+
+        size_type erase(const Key &key)
+        {
+            const_iterator pos = find(key);
+            if (pos == end())
+                return 0;
+
+            erase(pos);
+            return 1;
+        }
+
+        void swap(flat_set &that)
+        {
+            std::swap(keys_, that.keys_);
+            std::swap(comp_, that.comp_);
+        }
+
+    private:
+        // Sorts the keys from pos on and merges them into the sorted distinct keys before pos.
+        void sort_unique(size_type pos)
+        {
+            std::sort(keys_.data() + pos, keys_.data() + size(), comp_);
+            merge_unique(pos);
+        }
+
+        // Merges the two sorted runs split at pos and drops the duplicates. The merge is stable,
+        // so of the equal keys the one of the first run comes first and is kept.
+        void merge_unique(size_type pos)
+        {
+            Key *first = keys_.data();
+            Key *last  = keys_.data() + size();
+
+            // keys appended in order need no merge
+            if (pos != 0 && pos != size() && comp_(first[pos], first[pos - 1]))
+                std::inplace_merge(first, first + pos, last, comp_);
+
+            Key *unique_end = std::unique(first, last, [this](const Key &lhs, const Key &rhs) { return !comp_(lhs, rhs); });
+            keys_.erase(keys_.begin() + (unique_end - first), keys_.end());
+        }
+
+    // member data
+    private:
+        container_type                    keys_;
+        [[no_unique_address]] key_compare comp_;
+    };
+
+    //==================================================================================================
+
+    // Map kept as two parallel sorted vectors, one of the keys and one of the mapped values. A lookup
+    // binary searches the keys only, so the values never pollute the cache lines it touches. Bulk
+    // loads go through the range insert: the new pairs are sorted once and merged with the old ones.
+    //
+    // Elements are accessed through the proxy reference std::pair<const Key&, T&>.
+    template <class Key, class T, class Compare = std::less<Key>,
+              class KeyAllocator = std::allocator<Key>, class MappedAllocator = std::allocator<T>>
+    class flat_map
+    {
+    // types
+    public:
+        using key_type              = Key;
+        using mapped_type           = T;
+        using value_type            = std::pair<Key, T>;
+        using key_compare           = Compare;
+        using size_type             = size_t;
+        using difference_type       = ptrdiff_t;
+        using reference             = std::pair<const Key&, T&>;
+        using const_reference       = std::pair<const Key&, const T&>;
+        using key_container_type    = vector<Key, KeyAllocator>;
+        using mapped_container_type = vector<T, MappedAllocator>;
+
+    private:
+        // The iterators walk the rows, operator[] looks up a key.
+        struct row_access
+        {
+            template <class Map>
+            static auto get(Map &map, size_type idx)
+            {
+                return map.row(idx);
+            }
+        };
+
+    public:
+        using iterator       = my_detail::indexed_iterator<      flat_map,       reference, row_access>;
+        using const_iterator = my_detail::indexed_iterator<const flat_map, const_reference, row_access>;
+
+    // friends
+
+        friend std::ostream &operator <<(std::ostream &out, const flat_map &self)
+        {
+            out << "size = " << self.size() << " {";
+            for (size_type idx = 0; idx < self.size(); ++idx)
+                out << " " << self.keys_[idx] << ": " << self.values_[idx];
+
+            return out << " }\n";
+        }
+
+    // member functions
+    public:
+        flat_map():
+        keys_  (),
+        values_(),
+        comp_  ()
+        {}
+
+        explicit flat_map(const Compare &comp):
+        keys_  (),
+        values_(),
+        comp_  (comp)
+        {}
+
+        flat_map(std::initializer_list<value_type> init_list, const Compare &comp = Compare()):
+        flat_map(comp)
+        {
+            insert(init_list);
+        }
+
+        template <class InputIt>
+        flat_map(InputIt first, InputIt last, const Compare &comp = Compare()):
+        flat_map(comp)
+        {
+            insert(first, last);
+        }
+
+        // Sorts the pairs by key, of the equal keys the first one is kept.
+        flat_map(key_container_type &&keys, mapped_container_type &&values, const Compare &comp = Compare()):
+        flat_map(comp)
+        {
+            assert(keys.size() == values.size());
+
+            vector<value_type> batch;
+            batch.reserve(keys.size());
+            for (size_type idx = 0; idx < keys.size(); ++idx)
+                batch.emplace_back(std::move(keys[idx]), std::move(values[idx]));
+
+            sort_batch(batch);
+            merge_batch(batch);
+        }
+
+        // Takes the keys and the values as they are, without copying or sorting them.
+        flat_map(sorted_unique_t, key_container_type &&keys, mapped_container_type &&values, const Compare &comp = Compare()):
+        keys_  (std::move(keys)),
+        values_(std::move(values)),
+        comp_  (comp)
+        {
+            assert(keys_.size() == values_.size());
+            assert(my_detail::is_sorted_unique(keys_.data(), keys_.size(), comp_));
+        }
+
+        bool operator ==(const flat_map &that) const
+        {
+            return size() == that.size() && std::equal(  keys_.data(),   keys_.data() + size(), that.  keys_.data())
+                                         && std::equal(values_.data(), values_.data() + size(), that.values_.data());
+        }
+
+        // The sorted keys.
+        const key_container_type &keys() const
+        {
+            return keys_;
+        }
+
+        // The values in the order of the keys. They can be updated in bulk, the keys can not.
+        std::span<T> values()
+        {
+            return std::span<T>(values_.data(), values_.size());
+        }
+
+        std::span<const T> values() const
+        {
+            return std::span<const T>(values_.data(), values_.size());
+        }
+
+        T &at(const Key &key)
+        {
+            size_type idx = find_index(key);
+            if (idx == size()) throw std::out_of_range("flat_map::at: no such key");
+
+            return values_[idx];
+        }
+
+        const T &at(const Key &key) const
+        {
+            size_type idx = find_index(key);
+            if (idx == size()) throw std::out_of_range("flat_map::at: no such key");
+
+            return values_[idx];
+        }
+
+        T &operator [](const Key &key)
+        {
+            return values_[try_emplace_index(key).first];
+        }
+
+        T &operator [](Key &&key)
+        {
+            return values_[try_emplace_index(std::move(key)).first];
+        }
+
+        inline iterator        begin()       { return iterator(this, 0); }
+        inline const_iterator  begin() const { return const_iterator(this, 0); }
+        inline const_iterator cbegin() const { return const_iterator(this, 0); }
+
+        inline iterator        end()       { return iterator(this, size()); }
+        inline const_iterator  end() const { return const_iterator(this, size()); }
+        inline const_iterator cend() const { return const_iterator(this, size()); }
+
+        inline bool empty() const
+        {
+            return keys_.empty();
+        }
+
+        inline size_type size() const
+        {
+            return keys_.size();
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            keys_  .reserve(new_capacity);
+            values_.reserve(new_capacity);
+        }
+
+        void clear()
+        {
+            keys_  .clear();
+            values_.clear();
+        }
+
+        iterator       lower_bound(const Key &key)       { return iterator      (this, lower_bound_index(key)); }
+        const_iterator lower_bound(const Key &key) const { return const_iterator(this, lower_bound_index(key)); }
+
+        iterator       upper_bound(const Key &key)       { return iterator      (this, upper_bound_index(key)); }
+        const_iterator upper_bound(const Key &key) const { return const_iterator(this, upper_bound_index(key)); }
+
+        iterator       find(const Key &key)       { return iterator      (this, find_index(key)); }
+        const_iterator find(const Key &key) const { return const_iterator(this, find_index(key)); }
+
+        bool contains(const Key &key) const
+        {
+            return find_index(key) != size();
+        }
+
+        size_type count(const Key &key) const
+        {
+            return contains(key) ? 1 : 0;
+        }
+
+        // Constructs the value from args if there is no such key yet.
+        template <class... Args>
+        std::pair<iterator, bool> try_emplace(const Key &key, Args&&... args)
+        {
+            auto [idx, inserted] = try_emplace_index(key, std::forward<Args>(args)...);
+            return {iterator(this, idx), inserted};
+        }
+
+        template <class... Args>
+        std::pair<iterator, bool> try_emplace(Key &&key, Args&&... args)
+        {
+            auto [idx, inserted] = try_emplace_index(std::move(key), std::forward<Args>(args)...);
+            return {iterator(this, idx), inserted};
+        }
+
+        std::pair<iterator, bool> insert(const value_type &value)
+        {
+            return try_emplace(value.first, value.second);
+        }
+
+        std::pair<iterator, bool> insert(value_type &&value)
+        {
+            return try_emplace(std::move(value.first), std::move(value.second));
+        }
+
+        template <class M>
+        std::pair<iterator, bool> insert_or_assign(const Key &key, M &&value)
+        {
+            auto [idx, inserted] = try_emplace_index(key, std::forward<M>(value));
+            if (!inserted)
+                values_[idx] = std::forward<M>(value);
+
+            return {iterator(this, idx), inserted};
+        }
+
+        // Sorts the new pairs by key and merges them with the old ones in one pass. Of the equal
+        // keys the one already in the map is kept, then the first one of the range.
+        template <class InputIt>
+        void insert(InputIt first, InputIt last)
+        {
+            vector<value_type> batch(first, last);
+
+            sort_batch(batch);
+            merge_batch(batch);
+        }
+
+        void insert(std::initializer_list<value_type> init_list)
+        {
+            insert(init_list.begin(), init_list.end());
+        }
+
+        // The pairs are already sorted by key and the keys are distinct, they are only merged.
+        template <class InputIt>
+        void insert(sorted_unique_t, InputIt first, InputIt last)
+        {
+            vector<value_type> batch(first, last);
+
+            assert(std::is_sorted(batch.data(), batch.data() + batch.size(), [this](const value_type &lhs, const value_type &rhs)
+            {
+                return comp_(lhs.first, rhs.first);
+            }));
+            merge_batch(batch);
+        }
+
+        iterator erase(iterator pos)
+        {
+            size_type idx = pos.index();
+
+            keys_  .erase(keys_  .begin() + idx);
+            values_.erase(values_.begin() + idx);
+            return iterator(this, idx);
+        }
+
+        size_type erase(const Key &key)
+        {
+            size_type idx = find_index(key);
+            if (idx == size())
+                return 0;
+
+            erase(iterator(this, idx));
+            return 1;
+        }
+
+        void swap(flat_map &that)
+        {
+            std::swap(keys_  , that.keys_);
+            std::swap(values_, that.values_);
+            std::swap(comp_  , that.comp_);
+        }
+
+    private:
+        reference row(size_type idx)
+        {
+            return reference(keys_[idx], values_[idx]);
+        }
+
+        const_reference row(size_type idx) const
+        {
+            return const_reference(keys_[idx], values_[idx]);
+        }
+
+        size_type lower_bound_index(const Key &key) const
+        {
+            return my_detail::branchless_lower_bound(keys_.data(), size(), key, comp_);
+        }
+
+        size_type upper_bound_index(const Key &key) const
+        {
+            return my_detail::branchless_upper_bound(keys_.data(), size(), key, comp_);
+        }
+
+        // Index of the key, size() if there is none.
+        size_type find_index(const Key &key) const
+        {
+            size_type idx = lower_bound_index(key);
+            return idx != size() && !comp_(key, keys_[idx]) ? idx : size();
+        }
+
+        template <class K, class... Args>
+        std::pair<size_type, bool> try_emplace_index(K &&key, Args&&... args)
+        {
+            size_type idx = lower_bound_index(key);
+            if (idx != size() && !comp_(key, keys_[idx]))
+                return {idx, false};
+
+            values_.emplace(values_.begin() + idx, std::forward<Args>(args)...);
+            try
+            {
+                keys_.emplace(keys_.begin() + idx, std::forward<K>(key));
+            }
+            catch (...)
+            {
+                values_.erase(values_.begin() + idx);
+                throw;
+            }
+
+            return {idx, true};
+        }
+
+        void sort_batch(vector<value_type> &batch) const
+        {
+            std::stable_sort(batch.data(), batch.data() + batch.size(), [this](const value_type &lhs, const value_type &rhs)
+            {
+                return comp_(lhs.first, rhs.first);
+            });
+        }
+
+        // Merges the pairs sorted by key into the map. A key equal to the last merged one is
+        // skipped, and on ties the old pair goes first, so the old pairs are all kept.
+        void merge_batch(vector<value_type> &batch)
+        {
+            if (batch.empty())
+                return;
+
+            key_container_type    new_keys  (keys_  .get_allocator());
+            mapped_container_type new_values(values_.get_allocator());
+
+            new_keys  .reserve(size() + batch.size());
+            new_values.reserve(size() + batch.size());
+
+            size_type old_idx   = 0;
+            size_type batch_idx = 0;
+
+            while (old_idx < size() || batch_idx < batch.size())
+            {
+                bool take_old = batch_idx == batch.size() ||
+                                (old_idx < size() && !comp_(batch[batch_idx].first, keys_[old_idx]));
+
+                if (take_old)
+                {
+                    new_keys  .push_back(std::move(  keys_[old_idx]));
+                    new_values.push_back(std::move(values_[old_idx]));
+                    ++old_idx;
+                    continue;
+                }
+
+                value_type &pair = batch[batch_idx++];
+                if (new_keys.empty() || comp_(new_keys.back(), pair.first))
+                {
+                    new_keys  .push_back(std::move(pair.first));
+                    new_values.push_back(std::move(pair.second));
+                }
+            }
+
+            keys_   = std::move(new_keys);
+            values_ = std::move(new_values);
+        }
+
+    // member data
+    private:
+        key_container_type                keys_;
+        mapped_container_type             values_;
+        [[no_unique_address]] key_compare comp_;
+    };
+}
+
+#endif // FLAT_MAP_HPP
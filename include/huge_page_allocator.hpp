@@ -0,0 +1,195 @@
+#ifndef HUGE_PAGE_ALLOCATOR_HPP
+#define HUGE_PAGE_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <system_error>
+
+#include <sys/mman.h>
+
+//==================================================================================================
+
+namespace my_detail
+{
+    static constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+    inline size_t round_to_huge_page(size_t bytes)
+    {
+        return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+    }
+
+    // Maps bytes (a multiple of the huge page size) from the reserved huge page pool, else maps
+    // normal pages aligned to the huge page size and asks for transparent huge pages.
+    inline void *map_huge_pages(size_t bytes)
+    {
+    #ifdef MAP_HUGETLB
+        void *data = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data != MAP_FAILED)
+            return data;
+    #endif
+
+        // the extra huge page is cut off to align the mapping
+        size_t map_size = bytes + huge_page_size;
+
+        char *map = static_cast<char *>(::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (map == MAP_FAILED)
+            return nullptr;
+
+        char  *data_begin = map + (huge_page_size - reinterpret_cast<uintptr_t>(map) % huge_page_size) % huge_page_size;
+        size_t head       = data_begin - map;
+        size_t tail       = map_size - head - bytes;
+
+        if (head != 0) ::munmap(map, head);
+        if (tail != 0) ::munmap(data_begin + bytes, tail);
+
+    #ifdef MADV_HUGEPAGE
+        ::madvise(data_begin, bytes, MADV_HUGEPAGE);
+    #endif
+        return data_begin;
+    }
+
+    // Bytes of the mappings of [data, data + bytes) backed by huge pages, from /proc/self/smaps.
+    inline size_t huge_page_bytes(const void *data, size_t bytes)
+    {
+        FILE *smaps = std::fopen("/proc/self/smaps", "r");
+        if (!smaps)
+            throw std::system_error(errno, std::generic_category(), "huge_page_bytes: open /proc/self/smaps");
+
+        uintptr_t first = reinterpret_cast<uintptr_t>(data);
+        uintptr_t last  = first + bytes;
+
+        size_t huge_kb  = 0;
+        bool   overlaps = false;
+
+        char line[512];
+        while (std::fgets(line, sizeof(line), smaps))
+        {
+            unsigned long map_begin = 0;
+            unsigned long map_end   = 0;
+            size_t        kb        = 0;
+
+            // a mapping header is "begin-end perms ...", its fields are "Name: value kB"
+            if (std::sscanf(line, "%lx-%lx ", &map_begin, &map_end) == 2)
+                overlaps = map_begin < last && first < map_end;
+            else if (overlaps && (std::sscanf(line, "AnonHugePages: %zu kB", &kb) == 1 ||
+                                  std::sscanf(line, "Private_Hugetlb: %zu kB", &kb) == 1 ||
+                                  std::sscanf(line, "Shared_Hugetlb: %zu kB", &kb) == 1))
+                huge_kb += kb;
+        }
+
+        std::fclose(smaps);
+
+        // a mapping merged with its neighbours is counted as a whole
+        return std::min(huge_kb * 1024, bytes);
+    }
+}
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace my_std
+{
+    // Allocator for huge buffers: blocks of at least Threshold bytes are mapped with MAP_HUGETLB
+    // when the system has reserved huge pages, else with MADV_HUGEPAGE on 2 MiB aligned normal
+    // pages; smaller blocks come from malloc. Huge blocks grow with mremap, so vectors of trivially
+    // relocatable elements do not copy them.
+    template <class T, size_t Threshold = my_detail::huge_page_size>
+    class huge_page_allocator
+    {
+    // types
+    public:
+        using value_type = T;
+
+        template <class U>
+        struct rebind
+        {
+            using other = huge_page_allocator<U, Threshold>;
+        };
+
+    // member functions
+    public:
+        huge_page_allocator() = default;
+
+        template <class U>
+        huge_page_allocator(const huge_page_allocator<U, Threshold> &) {}
+
+        T *allocate(size_t count)
+        {
+            if (count == 0) return nullptr;
+            if (count > SIZE_MAX / 2 / sizeof(T)) throw std::bad_alloc();
+
+            size_t bytes = count * sizeof(T);
+
+            void *data = is_huge(bytes) ? my_detail::map_huge_pages(my_detail::round_to_huge_page(bytes))
+                                        : std::malloc(bytes);
+            if (!data) throw std::bad_alloc();
+
+            return static_cast<T *>(data);
+        }
+
+        void deallocate(T *data, size_t count)
+        {
+            size_t bytes = count * sizeof(T);
+
+            if (is_huge(bytes))
+                ::munmap(data, my_detail::round_to_huge_page(bytes));
+            else
+                std::free(data);
+        }
+
+        // Returns nullptr when the block changes its kind (heap or mapped), then the caller
+        // allocates a new block and moves the elements itself.
+        T *reallocate(T *data, size_t old_count, size_t new_count)
+        {
+            size_t old_bytes = old_count * sizeof(T);
+            size_t new_bytes = new_count * sizeof(T);
+
+            if (is_huge(old_bytes) != is_huge(new_bytes))
+                return nullptr;
+
+            if (!is_huge(new_bytes))
+            {
+                void *new_data = std::realloc(data, new_bytes);
+                if (!new_data) throw std::bad_alloc();
+
+                return static_cast<T *>(new_data);
+            }
+
+            size_t old_map_size = my_detail::round_to_huge_page(old_bytes);
+            size_t new_map_size = my_detail::round_to_huge_page(new_bytes);
+            if (old_map_size == new_map_size)
+                return data;
+
+            void *new_data = ::mremap(data, old_map_size, new_map_size, MREMAP_MAYMOVE);
+            if (new_data == MAP_FAILED)
+                return nullptr;
+
+        #ifdef MADV_HUGEPAGE
+            ::madvise(new_data, new_map_size, MADV_HUGEPAGE);
+        #endif
+            return static_cast<T *>(new_data);
+        }
+
+        // Bytes of the block of count elements which are backed by huge pages now.
+        static size_t huge_page_bytes(const T *data, size_t count)
+        {
+            if (!data || !is_huge(count * sizeof(T)))
+                return 0;
+
+            return my_detail::huge_page_bytes(data, my_detail::round_to_huge_page(count * sizeof(T)));
+        }
+
+        static constexpr bool is_huge(size_t bytes)
+        {
+            return bytes >= Threshold;
+        }
+
+        template <class U>
+        bool operator ==(const huge_page_allocator<U, Threshold> &) const { return true; }
+    };
+}
+
+#endif // HUGE_PAGE_ALLOCATOR_HPP
@@ -0,0 +1,283 @@
+#ifndef INCREMENTAL_VECTOR_HPP
+#define INCREMENTAL_VECTOR_HPP
+
+#include "vector.hpp"
+
+//==================================================================================================
+
+namespace my_std
+{
+    // Vector with bounded latency of every operation. When it outgrows its buffer, the new buffer is
+    // allocated, but the elements are not moved at once: the old buffer is kept and every following
+    // mutating operation moves at most MigrationStep elements to the new one, the way incremental
+    // rehashing works. Indexing stays O(1): element i is in the old buffer while migration has not
+    // reached it.
+    //
+    // The growth policy must grow the capacity at least by 1 + 1 / MigrationStep times, then the
+    // migration is over before the next growth.
+    template <class T, class Allocator = std::allocator<T>, size_t MigrationStep = 64, class GrowthPolicy = growth_x2>
+    class incremental_vector
+    {
+    // assert
+        static_assert(MigrationStep != 0);
+
+    // types
+    public:
+        using value_type      = T;
+        using allocator_type  = Allocator;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+
+        using iterator       = my_detail::indexed_iterator<      incremental_vector,       T&>;
+        using const_iterator = my_detail::indexed_iterator<const incremental_vector, const T&>;
+
+    // friends
+
+        friend std::ostream &operator <<(std::ostream &out, const incremental_vector &self)
+        {
+            out <<
+                "incremental_vector (" << &self << ")\n" <<
+                "\tsize      = " << self.size()          << "\n" <<
+                "\tcapacity  = " << self.capacity()      << "\n" <<
+                "\tmigrating = " << self.old_size_ - self.migrated_ << "\n";
+
+            for (size_type idx = 0; idx < self.size(); ++idx)
+                out << "\n# " << idx << "\n" << self[idx];
+
+            return out;
+        }
+
+    // member functions
+    public:
+        explicit incremental_vector(const Allocator &allocator = Allocator()):
+        allocator_   (allocator),
+        begin_       (nullptr),
+        size_        (0),
+        capacity_    (0),
+        old_begin_   (nullptr),
+        old_size_    (0),
+        old_capacity_(0),
+        migrated_    (0)
+        {}
+
+        incremental_vector(const incremental_vector &that):
+        incremental_vector(std::allocator_traits<Allocator>::select_on_container_copy_construction(that.allocator_))
+        {
+            begin_    = std::allocator_traits<Allocator>::allocate(allocator_, that.size());
+            capacity_ = that.size();
+
+            for (; size_ < that.size(); ++size_)
+                std::allocator_traits<Allocator>::construct(allocator_, begin_ + size_, that[size_]);
+        }
+
+        incremental_vector(incremental_vector &&that):
+        incremental_vector(that.allocator_)
+        {
+            swap(that);
+        }
+
+        ~incremental_vector()
+        {
+            clear();
+            std::allocator_traits<Allocator>::deallocate(allocator_, begin_, capacity_);
+        }
+
+        incremental_vector &operator =(incremental_vector that)
+        {
+            swap(that);
+            return *this;
+        }
+
+        void swap(incremental_vector &that)
+        {
+            std::swap(allocator_   , that.allocator_);
+            std::swap(begin_       , that.begin_);
+            std::swap(size_        , that.size_);
+            std::swap(capacity_    , that.capacity_);
+            std::swap(old_begin_   , that.old_begin_);
+            std::swap(old_size_    , that.old_size_);
+            std::swap(old_capacity_, that.old_capacity_);
+            std::swap(migrated_    , that.migrated_);
+        }
+
+        reference at(size_type pos)
+        {
+            assert(pos < size());
+            return *locate(pos);
+        }
+
+        const_reference at(size_type pos) const
+        {
+            assert(pos < size());
+            return *locate(pos);
+        }
+
+        inline       reference operator [](size_type pos)       { return at(pos); }
+        inline const_reference operator [](size_type pos) const { return at(pos); }
+
+        inline       reference front()       { return at(0); }
+        inline const_reference front() const { return at(0); }
+
+        inline       reference back ()       { return at(size() - 1); }
+        inline const_reference back () const { return at(size() - 1); }
+
+        inline iterator        begin()       { return iterator(this, 0); }
+        inline const_iterator  begin() const { return const_iterator(this, 0); }
+        inline const_iterator cbegin() const { return const_iterator(this, 0); }
+
+        inline iterator        end()       { return iterator(this, size()); }
+        inline const_iterator  end() const { return const_iterator(this, size()); }
+        inline const_iterator cend() const { return const_iterator(this, size()); }
+
+        inline bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        inline size_type size() const
+        {
+            return size_;
+        }
+
+        inline size_type capacity() const
+        {
+            return capacity_;
+        }
+
+        // True while elements are still being moved from the previous buffer.
+        inline bool migrating() const
+        {
+            return old_begin_ != nullptr;
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            if (new_capacity > capacity_)
+                start_migration(GrowthPolicy::fit(new_capacity, sizeof(T)));
+        }
+
+        void clear()
+        {
+            for (size_type idx = 0; idx < size_; ++idx)
+                std::allocator_traits<Allocator>::destroy(allocator_, locate(idx));
+
+            size_     = 0;
+            old_size_ = 0;
+            finish_migration();
+        }
+
+        void push_back(const_reference value)
+        {
+            emplace_back(value);
+        }
+
+        void push_back(T &&value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        template <class... Args>
+        reference emplace_back(Args&&... args)
+        {
+            if (size_ == capacity_)
+            {
+                // the old buffer keeps living during the migration, so args stay valid
+                start_migration(GrowthPolicy::grow(capacity_, size_ + 1, sizeof(T)));
+            }
+
+            std::allocator_traits<Allocator>::construct(allocator_, begin_ + size_, std::forward<Args>(args)...);
+            ++size_;
+
+            migrate_step();
+            return begin_[size_ - 1];
+        }
+
+        void pop_back()
+        {
+            assert(!empty());
+
+            --size_;
+            std::allocator_traits<Allocator>::destroy(allocator_, locate(size_));
+
+            if (old_size_ > size_)
+                old_size_ = size_;
+
+            migrate_step();
+        }
+
+    private:
+        T *locate(size_type idx) const
+        {
+            if (idx >= migrated_ && idx < old_size_)
+                return old_begin_ + idx;
+
+            return begin_ + idx;
+        }
+
+        // Allocates the new buffer and leaves the elements in the old one. A migration in progress is
+        // finished first, it is empty if the growth policy follows the requirement above.
+        void start_migration(size_type new_capacity)
+        {
+            migrate(old_size_ - migrated_);
+
+            T *new_begin = std::allocator_traits<Allocator>::allocate(allocator_, new_capacity);
+
+            old_begin_    = begin_;
+            old_size_     = size_;
+            old_capacity_ = capacity_;
+            migrated_     = 0;
+
+            begin_    = new_begin;
+            capacity_ = new_capacity;
+
+            finish_migration();
+        }
+
+        void migrate_step()
+        {
+            migrate(std::min(MigrationStep, old_size_ - migrated_));
+        }
+
+        // Moves the next count elements of the old buffer to the new one.
+        void migrate(size_type count)
+        {
+            my_detail::relocate_n(allocator_, begin_ + migrated_, old_begin_ + migrated_, count);
+            migrated_ += count;
+
+            finish_migration();
+        }
+
+        // Frees the old buffer once all its elements are moved.
+        void finish_migration()
+        {
+            if (migrated_ < old_size_)
+                return;
+
+            if (old_begin_)
+                std::allocator_traits<Allocator>::deallocate(allocator_, old_begin_, old_capacity_);
+
+            old_begin_    = nullptr;
+            old_size_     = 0;
+            old_capacity_ = 0;
+            migrated_     = 0;
+        }
+
+    // member data
+    private:
+        Allocator allocator_;
+
+        T        *begin_;
+        size_type size_;
+        size_type capacity_;
+
+        // elements [migrated_, old_size_) are still in the old buffer
+        T        *old_begin_;
+        size_type old_size_;
+        size_type old_capacity_;
+        size_type migrated_;
+    };
+}
+
+#endif // INCREMENTAL_VECTOR_HPP
@@ -0,0 +1,61 @@
+#ifndef MALLOC_ALLOCATOR_HPP
+#define MALLOC_ALLOCATOR_HPP
+
+#include <cstdlib>
+#include <new>
+
+//==================================================================================================
+
+namespace my_std
+{
+    // Allocator on top of malloc/free. Provides reallocate(), so containers of trivially relocatable
+    // elements grow in place with realloc (which uses mremap for large blocks in glibc).
+    template <class T>
+    class malloc_allocator
+    {
+    // types
+    public:
+        using value_type = T;
+
+    // member functions
+    public:
+        malloc_allocator() = default;
+
+        template <class U>
+        malloc_allocator(const malloc_allocator<U> &) {}
+
+        T *allocate(size_t count)
+        {
+            if (count == 0) return nullptr;
+
+            void *data = std::malloc(count * sizeof(T));
+            if (!data) throw std::bad_alloc();
+
+            return static_cast<T *>(data);
+        }
+
+        void deallocate(T *data, size_t)
+        {
+            std::free(data);
+        }
+
+        T *reallocate(T *data, size_t, size_t new_count)
+        {
+            if (new_count == 0)
+            {
+                std::free(data);
+                return nullptr;
+            }
+
+            void *new_data = std::realloc(data, new_count * sizeof(T));
+            if (!new_data) throw std::bad_alloc();
+
+            return static_cast<T *>(new_data);
+        }
+
+        template <class U>
+        bool operator ==(const malloc_allocator<U> &) const { return true; }
+    };
+}
+
+#endif // MALLOC_ALLOCATOR_HPP
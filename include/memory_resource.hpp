@@ -0,0 +1,530 @@
+#ifndef MEMORY_RESOURCE_HPP
+#define MEMORY_RESOURCE_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "vector.hpp"
+
+//==================================================================================================
+
+namespace my_std::pmr
+{
+    // Polymorphic source of memory, the allocator is picked at runtime instead of by a template
+    // parameter, so containers over different resources are of the same type.
+    class memory_resource
+    {
+    // member functions
+    public:
+        virtual ~memory_resource() = default;
+
+        void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+        {
+            return do_allocate(bytes, alignment);
+        }
+
+        void deallocate(void *data, size_t bytes, size_t alignment = alignof(std::max_align_t))
+        {
+            do_deallocate(data, bytes, alignment);
+        }
+
+        // Memory allocated by this may be deallocated by that and vice versa.
+        bool is_equal(const memory_resource &that) const noexcept
+        {
+            return do_is_equal(that);
+        }
+
+        bool operator ==(const memory_resource &that) const noexcept
+        {
+            return this == &that || is_equal(that);
+        }
+
+    private:
+        virtual void *do_allocate  (size_t bytes, size_t alignment) = 0;
+        virtual void  do_deallocate(void *data, size_t bytes, size_t alignment) = 0;
+        virtual bool  do_is_equal  (const memory_resource &that) const noexcept = 0;
+    };
+
+    //--------------------------------------------------------------------------------------------------
+
+    // Resource on top of the global operator new/delete.
+    class new_delete_resource_t final : public memory_resource
+    {
+    private:
+        void *do_allocate(size_t bytes, size_t alignment) override
+        {
+            return ::operator new(bytes, std::align_val_t(alignment));
+        }
+
+        void do_deallocate(void *data, size_t bytes, size_t alignment) override
+        {
+            ::operator delete(data, bytes, std::align_val_t(alignment));
+        }
+
+        bool do_is_equal(const memory_resource &that) const noexcept override
+        {
+            return this == &that;
+        }
+    };
+
+    inline memory_resource *new_delete_resource() noexcept
+    {
+        static new_delete_resource_t resource;
+        return &resource;
+    }
+
+    inline std::atomic<memory_resource *> &default_resource() noexcept
+    {
+        static std::atomic<memory_resource *> resource(new_delete_resource());
+        return resource;
+    }
+
+    inline memory_resource *get_default_resource() noexcept
+    {
+        return default_resource().load(std::memory_order_acquire);
+    }
+
+    // Returns the previous default resource, nullptr resets it to new_delete_resource().
+    inline memory_resource *set_default_resource(memory_resource *resource) noexcept
+    {
+        if (!resource)
+            resource = new_delete_resource();
+
+        return default_resource().exchange(resource, std::memory_order_acq_rel);
+    }
+
+    //--------------------------------------------------------------------------------------------------
+
+    // Allocator which forwards to a memory_resource. It does not propagate on container copy, move
+    // and swap: a container keeps its resource for its whole life.
+    template <class T>
+    class polymorphic_allocator
+    {
+    // types
+    public:
+        using value_type = T;
+
+    // member functions
+    public:
+        polymorphic_allocator() noexcept:
+        resource_(get_default_resource())
+        {}
+
+        polymorphic_allocator(memory_resource *resource) noexcept:
+        resource_(resource)
+        {
+            assert(resource_);
+        }
+
+        template <class U>
+        polymorphic_allocator(const polymorphic_allocator<U> &that) noexcept:
+        resource_(that.resource())
+        {}
+
+        polymorphic_allocator &operator =(const polymorphic_allocator &that) = delete;
+
+        T *allocate(size_t count)
+        {
+            if (count > SIZE_MAX / sizeof(T))
+                throw std::bad_array_new_length();
+
+            return static_cast<T *>(resource_->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *data, size_t count)
+        {
+            resource_->deallocate(data, count * sizeof(T), alignof(T));
+        }
+
+        // Passes this allocator on to elements which use one, so nested containers share the
+        // resource of the outer one.
+        template <class U, class... Args>
+        void construct(U *data, Args&&... args)
+        {
+            std::uninitialized_construct_using_allocator(data, *this, std::forward<Args>(args)...);
+        }
+
+        // A copy of a container goes to the default resource, as in std::pmr.
+        polymorphic_allocator select_on_container_copy_construction() const
+        {
+            return polymorphic_allocator();
+        }
+
+        memory_resource *resource() const noexcept
+        {
+            return resource_;
+        }
+
+        template <class U>
+        bool operator ==(const polymorphic_allocator<U> &that) const noexcept
+        {
+            return *resource_ == *that.resource();
+        }
+
+    // member data
+    private:
+        memory_resource *resource_;
+    };
+
+    //--------------------------------------------------------------------------------------------------
+
+    // Arena: allocation bumps a pointer in the current chunk, deallocation does nothing, and all the
+    // memory goes back to the upstream resource at once in release() or in the destructor. Chunks
+    // grow geometrically, the first one may be a buffer supplied by the user.
+    class monotonic_buffer_resource : public memory_resource
+    {
+    // member functions
+    public:
+        explicit monotonic_buffer_resource(memory_resource *upstream = get_default_resource()):
+        monotonic_buffer_resource(nullptr, 0, upstream)
+        {}
+
+        explicit monotonic_buffer_resource(size_t initial_size, memory_resource *upstream = get_default_resource()):
+        monotonic_buffer_resource(nullptr, 0, upstream)
+        {
+            next_chunk_size_ = std::max(initial_size, sizeof(chunk_header_t));
+        }
+
+        monotonic_buffer_resource(void *buffer, size_t buffer_size, memory_resource *upstream = get_default_resource()):
+        upstream_       (upstream),
+        buffer_         (buffer),
+        buffer_size_    (buffer_size),
+        current_        (buffer),
+        space_          (buffer_size),
+        next_chunk_size_(std::max(buffer_size, min_chunk_size) * growth_factor),
+        chunks_         (nullptr)
+        {
+            assert(upstream_);
+        }
+
+        monotonic_buffer_resource(const monotonic_buffer_resource &that) = delete;
+        monotonic_buffer_resource &operator =(const monotonic_buffer_resource &that) = delete;
+
+        ~monotonic_buffer_resource() override
+        {
+            release();
+        }
+
+        // Frees every chunk, the user buffer is reused from the start.
+        void release()
+        {
+            while (chunks_)
+            {
+                chunk_header_t *prev = chunks_->prev;
+                upstream_->deallocate(chunks_, chunks_->size, alignof(std::max_align_t));
+                chunks_ = prev;
+            }
+
+            current_ = buffer_;
+            space_   = buffer_size_;
+        }
+
+        memory_resource *upstream_resource() const
+        {
+            return upstream_;
+        }
+
+    private:
+        struct chunk_header_t
+        {
+            chunk_header_t *prev;
+            size_t          size;
+        };
+
+        void *do_allocate(size_t bytes, size_t alignment) override
+        {
+            void *data = std::align(alignment, bytes, current_, space_);
+            if (!data)
+            {
+                add_chunk(bytes + alignment);
+                data = std::align(alignment, bytes, current_, space_);
+            }
+
+            current_  = static_cast<char *>(current_) + bytes;
+            space_   -= bytes;
+            return data;
+        }
+
+        void do_deallocate(void *, size_t, size_t) override
+        {}
+
+        bool do_is_equal(const memory_resource &that) const noexcept override
+        {
+            return this == &that;
+        }
+
+        void add_chunk(size_t required)
+        {
+            size_t chunk_size = std::max(next_chunk_size_, required + sizeof(chunk_header_t));
+
+            chunk_header_t *chunk = static_cast<chunk_header_t *>(
+                upstream_->allocate(chunk_size, alignof(std::max_align_t)));
+
+            chunk->prev = chunks_;
+            chunk->size = chunk_size;
+            chunks_     = chunk;
+
+            current_ = chunk + 1;
+            space_   = chunk_size - sizeof(chunk_header_t);
+
+            next_chunk_size_ = chunk_size * growth_factor;
+        }
+
+    // static data
+    private:
+        static constexpr size_t min_chunk_size = 1024;
+        static constexpr size_t growth_factor  = 2;
+
+    // member data
+    private:
+        memory_resource *upstream_;
+
+        void  *buffer_;
+        size_t buffer_size_;
+
+        void  *current_;
+        size_t space_;
+        size_t next_chunk_size_;
+
+        chunk_header_t *chunks_;
+    };
+
+    //--------------------------------------------------------------------------------------------------
+
+    struct pool_options
+    {
+        size_t max_blocks_per_chunk        = 1024;
+        size_t largest_required_pool_block = 4096;
+    };
+
+    // Single threaded pools of power of two sized blocks. A block goes back to the free list of its
+    // pool on deallocation and is reused by the next allocation of the same size class. Blocks larger
+    // than largest_required_pool_block come straight from the upstream resource.
+    class unsynchronized_pool_resource : public memory_resource
+    {
+    // member functions
+    public:
+        explicit unsynchronized_pool_resource(memory_resource *upstream = get_default_resource()):
+        unsynchronized_pool_resource(pool_options(), upstream)
+        {}
+
+        explicit unsynchronized_pool_resource(const pool_options &options,
+                                              memory_resource *upstream = get_default_resource()):
+        upstream_(upstream),
+        options_ (options),
+        large_   (nullptr)
+        {
+            assert(upstream_);
+
+            options_.max_blocks_per_chunk        = std::max<size_t>(options_.max_blocks_per_chunk, 1);
+            options_.largest_required_pool_block = std::bit_ceil(std::clamp(options_.largest_required_pool_block,
+                                                                            min_block_size, max_block_size));
+
+            for (pool_t &pool : pools_)
+                pool = {nullptr, nullptr, 1};
+        }
+
+        unsynchronized_pool_resource(const unsynchronized_pool_resource &that) = delete;
+        unsynchronized_pool_resource &operator =(const unsynchronized_pool_resource &that) = delete;
+
+        ~unsynchronized_pool_resource() override
+        {
+            release();
+        }
+
+        // Frees every chunk and every large block, even the ones not deallocated.
+        void release()
+        {
+            for (size_t pool_idx = 0; pool_idx < pool_count; ++pool_idx)
+            {
+                pool_t &pool = pools_[pool_idx];
+
+                while (pool.chunks)
+                {
+                    chunk_header_t *prev = pool.chunks->prev;
+                    upstream_->deallocate(pool.chunks, pool.chunks->size, alignof(std::max_align_t));
+                    pool.chunks = prev;
+                }
+                pool = {nullptr, nullptr, 1};
+            }
+
+            while (large_)
+            {
+                large_header_t *next = large_->next;
+                upstream_->deallocate(large_->base, large_->size, large_->alignment);
+                large_ = next;
+            }
+        }
+
+        memory_resource *upstream_resource() const
+        {
+            return upstream_;
+        }
+
+        pool_options options() const
+        {
+            return options_;
+        }
+
+    private:
+        struct chunk_header_t
+        {
+            chunk_header_t *prev;
+            size_t          size;
+        };
+
+        struct free_block_t
+        {
+            free_block_t *next;
+        };
+
+        struct pool_t
+        {
+            free_block_t   *free_blocks;
+            chunk_header_t *chunks;
+            size_t          next_blocks_per_chunk;
+        };
+
+        // Stored right before a large block.
+        struct large_header_t
+        {
+            large_header_t *prev;
+            large_header_t *next;
+            void           *base;
+            size_t          size;
+            size_t          alignment;
+        };
+
+        void *do_allocate(size_t bytes, size_t alignment) override
+        {
+            if (bytes > options_.largest_required_pool_block || alignment > alignof(std::max_align_t))
+                return allocate_large(bytes, alignment);
+
+            // a power of two block is aligned to its size, up to the chunk alignment
+            size_t  pool_idx = pool_of(std::max(bytes, alignment));
+            pool_t &pool     = pools_[pool_idx];
+            if (!pool.free_blocks)
+                add_chunk(pool, block_size(pool_idx));
+
+            free_block_t *block = pool.free_blocks;
+            pool.free_blocks = block->next;
+            return block;
+        }
+
+        void do_deallocate(void *data, size_t bytes, size_t alignment) override
+        {
+            if (bytes > options_.largest_required_pool_block || alignment > alignof(std::max_align_t))
+            {
+                deallocate_large(data);
+                return;
+            }
+
+            pool_t &pool = pools_[pool_of(std::max(bytes, alignment))];
+
+            free_block_t *block = static_cast<free_block_t *>(data);
+            block->next      = pool.free_blocks;
+            pool.free_blocks = block;
+        }
+
+        bool do_is_equal(const memory_resource &that) const noexcept override
+        {
+            return this == &that;
+        }
+
+        // Carves a new chunk into free blocks, chunks of a pool grow twice up to max_blocks_per_chunk.
+        void add_chunk(pool_t &pool, size_t block_size)
+        {
+            size_t block_count = pool.next_blocks_per_chunk;
+            size_t chunk_size  = header_size + block_count * block_size;
+
+            char *chunk = static_cast<char *>(upstream_->allocate(chunk_size, alignof(std::max_align_t)));
+
+            chunk_header_t *header = reinterpret_cast<chunk_header_t *>(chunk);
+            header->prev = pool.chunks;
+            header->size = chunk_size;
+            pool.chunks  = header;
+
+            for (size_t idx = block_count; idx-- > 0;)
+            {
+                free_block_t *block = reinterpret_cast<free_block_t *>(chunk + header_size + idx * block_size);
+                block->next      = pool.free_blocks;
+                pool.free_blocks = block;
+            }
+
+            pool.next_blocks_per_chunk = std::min(block_count * 2, options_.max_blocks_per_chunk);
+        }
+
+        void *allocate_large(size_t bytes, size_t alignment)
+        {
+            alignment = std::max(alignment, alignof(large_header_t));
+
+            size_t offset = (sizeof(large_header_t) + alignment - 1) / alignment * alignment;
+            size_t size   = offset + bytes;
+
+            char *base = static_cast<char *>(upstream_->allocate(size, alignment));
+
+            large_header_t *header = reinterpret_cast<large_header_t *>(base + offset) - 1;
+            *header = {nullptr, large_, base, size, alignment};
+
+            if (large_)
+                large_->prev = header;
+            large_ = header;
+
+            return base + offset;
+        }
+
+        void deallocate_large(void *data)
+        {
+            large_header_t *header = static_cast<large_header_t *>(data) - 1;
+
+            if (header->prev) header->prev->next = header->next;
+            else              large_             = header->next;
+
+            if (header->next)
+                header->next->prev = header->prev;
+
+            upstream_->deallocate(header->base, header->size, header->alignment);
+        }
+
+    // static functions
+    private:
+        static size_t pool_of(size_t bytes)
+        {
+            return std::bit_width(std::max(bytes, min_block_size) - 1) - min_block_log;
+        }
+
+        static size_t block_size(size_t pool)
+        {
+            return min_block_size << pool;
+        }
+
+    // static data
+    private:
+        static constexpr size_t min_block_size = sizeof(free_block_t);
+        static constexpr size_t max_block_size = size_t(1) << 20;
+        static constexpr size_t min_block_log  = std::bit_width(min_block_size) - 1;
+        static constexpr size_t pool_count     = std::bit_width(max_block_size) - min_block_log;
+
+        // keeps the blocks aligned to max_align_t
+        static constexpr size_t header_size = (sizeof(chunk_header_t) + alignof(std::max_align_t) - 1) /
+                                              alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    // member data
+    private:
+        memory_resource *upstream_;
+        pool_options     options_;
+
+        pool_t          pools_[pool_count];
+        large_header_t *large_;
+    };
+
+    //--------------------------------------------------------------------------------------------------
+
+    template <class T, class GrowthPolicy = growth_x2, size_t InlineCapacity = 0>
+    using vector = my_std::vector<T, polymorphic_allocator<T>, GrowthPolicy, InlineCapacity>;
+}
+
+#endif // MEMORY_RESOURCE_HPP
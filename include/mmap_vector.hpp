@@ -0,0 +1,299 @@
+#ifndef MMAP_VECTOR_HPP
+#define MMAP_VECTOR_HPP
+
+#include <cstdint>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "vector.hpp"
+
+//==================================================================================================
+
+namespace my_std
+{
+    // Vector of trivially copyable elements persisted in a file. The file is mapped into memory,
+    // so reopening it attaches to the stored elements without reading or copying them.
+    //
+    // File layout: header (magic, element size, size) padded to data_offset, then the elements.
+    // The capacity is the room left in the file after the header.
+    template <class T, class GrowthPolicy = growth_x2>
+    class mmap_vector
+    {
+    // assert
+        static_assert(std::is_trivially_copyable_v<T>);
+
+    // types
+    public:
+        using value_type      = T;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+        using pointer         = value_type*;
+        using const_pointer   = const value_type*;
+        using iterator        = pointer;
+        using const_iterator  = const_pointer;
+
+    // member functions
+    public:
+        explicit mmap_vector(const char *path):
+        fd_      (::open(path, O_RDWR | O_CREAT, 0644)),
+        map_     (nullptr),
+        map_size_(0)
+        {
+            if (fd_ == -1)
+                throw std::system_error(errno, std::generic_category(), "mmap_vector: open");
+
+            struct stat file_stat = {};
+            if (::fstat(fd_, &file_stat) == -1)
+                fail("mmap_vector: fstat");
+
+            size_t file_size = file_stat.st_size;
+            if (file_size == 0)
+            {
+                file_size = round_to_page(data_offset);
+                if (::ftruncate(fd_, file_size) == -1)
+                    fail("mmap_vector: ftruncate");
+            }
+
+            map_ = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (map_ == MAP_FAILED)
+                fail("mmap_vector: mmap");
+
+            map_size_ = file_size;
+
+            if (file_stat.st_size == 0)
+            {
+                header()->magic     = magic;
+                header()->elem_size = sizeof(T);
+                header()->size      = 0;
+            }
+            else if (file_size < data_offset || header()->magic != magic || header()->elem_size != sizeof(T))
+            {
+                errno = EINVAL;
+                fail("mmap_vector: not a mmap_vector file of this element type");
+            }
+            else if (header()->size > capacity())
+            {
+                errno = EINVAL;
+                fail("mmap_vector: stored size exceeds the file");
+            }
+        }
+
+        mmap_vector(const mmap_vector &that) = delete;
+
+        mmap_vector(mmap_vector &&that):
+        fd_      (that.fd_),
+        map_     (that.map_),
+        map_size_(that.map_size_)
+        {
+            that.fd_       = -1;
+            that.map_      = nullptr;
+            that.map_size_ = 0;
+        }
+
+        ~mmap_vector()
+        {
+            close();
+        }
+
+        mmap_vector &operator =(const mmap_vector &that) = delete;
+
+        mmap_vector &operator =(mmap_vector &&that)
+        {
+            std::swap(fd_      , that.fd_);
+            std::swap(map_     , that.map_);
+            std::swap(map_size_, that.map_size_);
+            return *this;
+        }
+
+        reference at(size_type pos)
+        {
+            assert(pos < size());
+            return data()[pos];
+        }
+
+        const_reference at(size_type pos) const
+        {
+            assert(pos < size());
+            return data()[pos];
+        }
+
+        inline       reference operator [](size_type pos)       { return at(pos); }
+        inline const_reference operator [](size_type pos) const { return at(pos); }
+
+        inline       reference front()       { return at(0); }
+        inline const_reference front() const { return at(0); }
+
+        inline       reference back ()       { return at(size() - 1); }
+        inline const_reference back () const { return at(size() - 1); }
+
+        inline T       *data()       { return reinterpret_cast<T *>(static_cast<char *>(map_) + data_offset); }
+        inline const T *data() const { return reinterpret_cast<const T *>(static_cast<const char *>(map_) + data_offset); }
+
+        inline iterator        begin()       { return data(); }
+        inline const_iterator  begin() const { return data(); }
+        inline const_iterator cbegin() const { return data(); }
+
+        inline iterator        end()       { return data() + size(); }
+        inline const_iterator  end() const { return data() + size(); }
+        inline const_iterator cend() const { return data() + size(); }
+
+        inline bool empty() const
+        {
+            return size() == 0;
+        }
+
+        inline size_type size() const
+        {
+            return header()->size;
+        }
+
+        inline size_type capacity() const
+        {
+            return (map_size_ - data_offset) / sizeof(T);
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            if (new_capacity > capacity())
+                remap(GrowthPolicy::fit(new_capacity, sizeof(T)));
+        }
+
+        void clear()
+        {
+            header()->size = 0;
+        }
+
+        void push_back(const_reference value)
+        {
+            T elem = value; // value may live in the mapping which is moved on growth
+
+            ensure_capacity(size() + 1);
+            data()[size()] = elem;
+            ++header()->size;
+        }
+
+        template <class... Args>
+        reference emplace_back(Args&&... args)
+        {
+            T elem(std::forward<Args>(args)...); // args may live in the mapping which is moved on growth
+
+            ensure_capacity(size() + 1);
+            data()[size()] = elem;
+            ++header()->size;
+
+            return back();
+        }
+
+        void pop_back()
+        {
+            assert(!empty());
+            --header()->size;
+        }
+
+        void resize(size_type count)
+        {
+            resize(count, T());
+        }
+
+        void resize(size_type count, const_reference value)
+        {
+            if (count > size())
+            {
+                T elem = value; // value may live in the mapping which is moved on growth
+
+                ensure_capacity(count);
+                my_detail::fill_n(data() + size(), count - size(), elem);
+            }
+            header()->size = count;
+        }
+
+        // Writes the mapped pages back to the file.
+        void flush()
+        {
+            if (::msync(map_, map_size_, MS_SYNC) == -1)
+                throw std::system_error(errno, std::generic_category(), "mmap_vector: msync");
+        }
+
+    private:
+        struct header_t
+        {
+            uint64_t magic;
+            uint64_t elem_size;
+            uint64_t size;
+        };
+
+        header_t       *header()       { return static_cast<header_t *>(map_); }
+        const header_t *header() const { return static_cast<const header_t *>(map_); }
+
+        void ensure_capacity(size_type required)
+        {
+            if (required > capacity())
+                remap(GrowthPolicy::grow(capacity(), required, sizeof(T)));
+        }
+
+        // Grows the file and the mapping, the kernel moves the mapping without copying the pages.
+        void remap(size_type new_capacity)
+        {
+            size_t new_map_size = round_to_page(data_offset + new_capacity * sizeof(T));
+
+            if (::ftruncate(fd_, new_map_size) == -1)
+                throw std::system_error(errno, std::generic_category(), "mmap_vector: ftruncate");
+
+            void *new_map = ::mremap(map_, map_size_, new_map_size, MREMAP_MAYMOVE);
+            if (new_map == MAP_FAILED)
+                throw std::system_error(errno, std::generic_category(), "mmap_vector: mremap");
+
+            map_      = new_map;
+            map_size_ = new_map_size;
+        }
+
+        void close()
+        {
+            if (map_)
+                ::munmap(map_, map_size_);
+            if (fd_ != -1)
+                ::close(fd_);
+
+            fd_       = -1;
+            map_      = nullptr;
+            map_size_ = 0;
+        }
+
+        [[noreturn]] void fail(const char *what)
+        {
+            int error = errno;
+            close();
+            throw std::system_error(error, std::generic_category(), what);
+        }
+
+    // static functions
+    private:
+        static size_t round_to_page(size_t size)
+        {
+            static const size_t page_size = ::sysconf(_SC_PAGESIZE);
+            return (size + page_size - 1) / page_size * page_size;
+        }
+
+    // static data
+    private:
+        static constexpr uint64_t magic       = 0x524f54434556504dull; // "MPVECTOR"
+        static constexpr size_t   data_offset = 64;
+
+        static_assert(sizeof(header_t) <= data_offset);
+        static_assert(alignof(T) <= data_offset);
+
+    // member data
+    private:
+        int    fd_;
+        void  *map_;
+        size_t map_size_;
+    };
+}
+
+#endif // MMAP_VECTOR_HPP
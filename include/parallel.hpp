@@ -0,0 +1,125 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <system_error>
+#include <thread>
+
+//==================================================================================================
+
+namespace my_std
+{
+    // Opt-in parallel execution of bulk loops over huge containers. Loops shorter than
+    // min_chunk_size elements per thread run on fewer threads, down to the calling one.
+    struct parallel_policy
+    {
+        explicit parallel_policy(size_t thread_count_   = std::thread::hardware_concurrency(),
+                                 size_t min_chunk_size_ = 1 << 16):
+        thread_count  (std::max<size_t>(thread_count_, 1)),
+        min_chunk_size(std::max<size_t>(min_chunk_size_, 1))
+        {}
+
+        size_t thread_count;
+        size_t min_chunk_size;
+    };
+}
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace my_detail
+{
+    inline size_t parallel_chunk_count(const my_std::parallel_policy &policy, size_t count)
+    {
+        size_t max_chunk_count = (count + policy.min_chunk_size - 1) / policy.min_chunk_size;
+        return std::max<size_t>(std::min(policy.thread_count, max_chunk_count), 1);
+    }
+
+    // Calls func(chunk, first, last) for chunks of [0, count), the last chunk on the calling thread.
+    // Exceptions are not handled, func must catch them.
+    template <class Func>
+    void parallel_chunks(const my_std::parallel_policy &policy, size_t count, Func func)
+    {
+        size_t chunk_count = parallel_chunk_count(policy, count);
+        size_t chunk_size  = (count + chunk_count - 1) / chunk_count;
+
+        std::unique_ptr<std::thread[]> threads(new std::thread[chunk_count - 1]);
+
+        for (size_t chunk = 0; chunk < chunk_count; ++chunk)
+        {
+            size_t first = std::min(count, chunk * chunk_size);
+            size_t last  = std::min(count, first + chunk_size);
+
+            if (chunk + 1 == chunk_count)
+            {
+                func(chunk, first, last);
+                break;
+            }
+
+            try
+            {
+                threads[chunk] = std::thread(func, chunk, first, last);
+            }
+            catch (const std::system_error &)
+            {
+                func(chunk, first, last);
+            }
+        }
+
+        for (size_t chunk = 0; chunk + 1 < chunk_count; ++chunk)
+            if (threads[chunk].joinable())
+                threads[chunk].join();
+    }
+
+    // Runs func(first, last) over chunks of [0, count) on several threads.
+    template <class Func>
+    void parallel_for(const my_std::parallel_policy &policy, size_t count, Func func)
+    {
+        parallel_chunks(policy, count, [&func](size_t, size_t first, size_t last)
+        {
+            func(first, last);
+        });
+    }
+
+    // Runs construct(first, last) over chunks of [0, count) on several threads. A chunk that throws
+    // must destroy its own elements. Then the completed chunks are destroyed with destroy(first, last)
+    // and the first exception is rethrown, so either all the elements are constructed or none.
+    //
+    // Every chunk is written by its own thread, so fresh pages are placed next to it (first touch).
+    template <class Construct, class Destroy>
+    void parallel_construct(const my_std::parallel_policy &policy, size_t count, Construct construct, Destroy destroy)
+    {
+        size_t chunk_count = parallel_chunk_count(policy, count);
+
+        std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[chunk_count]);
+
+        parallel_chunks(policy, count, [&construct, &errors](size_t chunk, size_t first, size_t last)
+        {
+            try
+            {
+                construct(first, last);
+            }
+            catch (...)
+            {
+                errors[chunk] = std::current_exception();
+            }
+        });
+
+        std::exception_ptr error = nullptr;
+        for (size_t chunk = 0; chunk < chunk_count && !error; ++chunk)
+            error = errors[chunk];
+
+        if (!error)
+            return;
+
+        parallel_chunks(policy, count, [&destroy, &errors](size_t chunk, size_t first, size_t last)
+        {
+            if (!errors[chunk])
+                destroy(first, last);
+        });
+        std::rethrow_exception(error);
+    }
+}
+
+#endif // PARALLEL_HPP
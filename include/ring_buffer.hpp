@@ -0,0 +1,345 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <span>
+
+#include "vector.hpp"
+
+//==================================================================================================
+
+namespace my_std
+{
+    // Double-ended queue in one circular buffer: push and pop are O(1) at both ends and never shift
+    // the other elements. The elements are the tail of the buffer from head followed by its front,
+    // spans() returns these two contiguous parts for bulk reads and writes.
+    //
+    // A full buffer grows by GrowthPolicy, the elements are relocated into the new buffer unwrapped
+    // (with memcpy when they are trivially relocatable). A window of fixed size reserves it once and
+    // pops the oldest element before pushing the next one, then it never allocates again.
+    template <class T, class Allocator = std::allocator<T>, class GrowthPolicy = growth_x2>
+    class ring_buffer
+    {
+    // types
+    public:
+        using value_type      = T;
+        using allocator_type  = Allocator;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+
+        using iterator       = my_detail::indexed_iterator<      ring_buffer,       T&>;
+        using const_iterator = my_detail::indexed_iterator<const ring_buffer, const T&>;
+
+    // friends
+
+        friend std::ostream &operator <<(std::ostream &out, const ring_buffer &self)
+        {
+            out << "size = " << self.size() << ", capacity = " << self.capacity() << " {";
+            for (const_reference elem : self)
+                out << " " << elem;
+
+            return out << " }\n";
+        }
+
+    // member functions
+    public:
+        explicit ring_buffer(const Allocator &allocator = Allocator()):
+        allocator_(allocator),
+        begin_    (nullptr),
+        capacity_ (0),
+        head_     (0),
+        size_     (0)
+        {}
+
+        explicit ring_buffer(size_type capacity, const Allocator &allocator = Allocator()):
+        ring_buffer(allocator)
+        {
+            reserve(capacity);
+        }
+
+        ring_buffer(const ring_buffer &that):
+        ring_buffer(std::allocator_traits<Allocator>::select_on_container_copy_construction(that.allocator_))
+        {
+            begin_    = std::allocator_traits<Allocator>::allocate(allocator_, that.size());
+            capacity_ = that.size();
+
+            for (; size_ < that.size(); ++size_)
+                std::allocator_traits<Allocator>::construct(allocator_, begin_ + size_, that[size_]);
+        }
+
+        ring_buffer(ring_buffer &&that):
+        ring_buffer(that.allocator_)
+        {
+            swap(that);
+        }
+
+        ~ring_buffer()
+        {
+            clear();
+            std::allocator_traits<Allocator>::deallocate(allocator_, begin_, capacity_);
+        }
+
+        ring_buffer &operator =(ring_buffer that)
+        {
+            swap(that);
+            return *this;
+        }
+
+        void swap(ring_buffer &that)
+        {
+            std::swap(allocator_, that.allocator_);
+            std::swap(begin_    , that.begin_);
+            std::swap(capacity_ , that.capacity_);
+            std::swap(head_     , that.head_);
+            std::swap(size_     , that.size_);
+        }
+
+        reference at(size_type pos)
+        {
+            assert(pos < size());
+            return begin_[physical(pos)];
+        }
+
+        const_reference at(size_type pos) const
+        {
+            assert(pos < size());
+            return begin_[physical(pos)];
+        }
+
+        inline       reference operator [](size_type pos)       { return at(pos); }
+        inline const_reference operator [](size_type pos) const { return at(pos); }
+
+        inline       reference front()       { return at(0); }
+        inline const_reference front() const { return at(0); }
+
+        inline       reference back ()       { return at(size() - 1); }
+        inline const_reference back () const { return at(size() - 1); }
+
+        // The elements in order as two contiguous parts, the second one is empty unless they wrap.
+        std::pair<std::span<T>, std::span<T>> spans()
+        {
+            size_type first_size = std::min(size_, capacity_ - head_);
+            return {std::span<T>(begin_ + head_, first_size), std::span<T>(begin_, size_ - first_size)};
+        }
+
+        std::pair<std::span<const T>, std::span<const T>> spans() const
+        {
+            size_type first_size = std::min(size_, capacity_ - head_);
+            return {std::span<const T>(begin_ + head_, first_size), std::span<const T>(begin_, size_ - first_size)};
+        }
+
+        inline iterator        begin()       { return iterator(this, 0); }
+        inline const_iterator  begin() const { return const_iterator(this, 0); }
+        inline const_iterator cbegin() const { return const_iterator(this, 0); }
+
+        inline iterator        end()       { return iterator(this, size()); }
+        inline const_iterator  end() const { return const_iterator(this, size()); }
+        inline const_iterator cend() const { return const_iterator(this, size()); }
+
+        inline bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        inline bool full() const
+        {
+            return size_ == capacity_;
+        }
+
+        inline size_type size() const
+        {
+            return size_;
+        }
+
+        inline size_type capacity() const
+        {
+            return capacity_;
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            if (new_capacity > capacity_)
+                realloc(GrowthPolicy::fit(new_capacity, sizeof(T)));
+        }
+
+        void clear()
+        {
+            pop_front(size_);
+        }
+
+        void push_back(const_reference value)
+        {
+            emplace_back(value);
+        }
+
+        void push_back(T &&value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        template <class... Args>
+        reference emplace_back(Args&&... args)
+        {
+            if (full())
+                return grow_with(false, std::forward<Args>(args)...);
+
+            T *slot = begin_ + physical(size_);
+
+            std::allocator_traits<Allocator>::construct(allocator_, slot, std::forward<Args>(args)...);
+            ++size_;
+
+            return *slot;
+        }
+
+        void push_front(const_reference value)
+        {
+            emplace_front(value);
+        }
+
+        void push_front(T &&value)
+        {
+            emplace_front(std::move(value));
+        }
+
+        template <class... Args>
+        reference emplace_front(Args&&... args)
+        {
+            if (full())
+                return grow_with(true, std::forward<Args>(args)...);
+
+            size_type new_head = head_ == 0 ? capacity_ - 1 : head_ - 1;
+
+            std::allocator_traits<Allocator>::construct(allocator_, begin_ + new_head, std::forward<Args>(args)...);
+            head_ = new_head;
+            ++size_;
+
+            return begin_[head_];
+        }
+
+        // Appends count elements copied from src in at most two contiguous chunks. src must not point
+        // into the buffer.
+        void append(const T *src, size_type count)
+        {
+            if (size_ + count > capacity_)
+                realloc(GrowthPolicy::grow(capacity_, size_ + count, sizeof(T)));
+
+            if (count == 0)
+                return;
+
+            size_type tail       = physical(size_);
+            size_type first_size = std::min(count, capacity_ - tail);
+
+            if constexpr (my_detail::is_constructible_by_memcpy_v<T, Allocator>)
+            {
+                my_detail::copy_bytes(begin_ + tail, src             , first_size           * sizeof(T));
+                my_detail::copy_bytes(begin_       , src + first_size, (count - first_size) * sizeof(T));
+                size_ += count;
+            }
+            else
+            {
+                for (size_type idx = 0; idx < count; ++idx)
+                    emplace_back(src[idx]);
+            }
+        }
+
+        void pop_back()
+        {
+            assert(!empty());
+
+            --size_;
+            std::allocator_traits<Allocator>::destroy(allocator_, begin_ + physical(size_));
+        }
+
+        void pop_front()
+        {
+            assert(!empty());
+
+            std::allocator_traits<Allocator>::destroy(allocator_, begin_ + head_);
+            head_ = physical(1);
+            --size_;
+        }
+
+        // Drops the count oldest elements.
+        void pop_front(size_type count)
+        {
+            assert(count <= size());
+
+            // the oldest elements up to the end of the buffer, then the wrapped rest
+            size_type till_end = std::min(count, capacity_ - head_);
+            my_detail::destroy_n(allocator_, begin_ + head_, till_end);
+            my_detail::destroy_n(allocator_, begin_, count - till_end);
+
+            head_  = count == size_ ? 0 : physical(count);
+            size_ -= count;
+        }
+
+    private:
+        // Index in the buffer of element idx, idx <= capacity_.
+        size_type physical(size_type idx) const
+        {
+            size_type pos = head_ + idx;
+            return pos >= capacity_ ? pos - capacity_ : pos;
+        }
+
+        // Emplaces into a new bigger buffer at the front or at the back. The new element goes first:
+        // args may refer to the old elements.
+        template <class... Args>
+        reference grow_with(bool front, Args&&... args)
+        {
+            size_type new_capacity = GrowthPolicy::grow(capacity_, size_ + 1, sizeof(T));
+            T        *new_begin    = std::allocator_traits<Allocator>::allocate(allocator_, new_capacity);
+            T        *slot         = new_begin + (front ? new_capacity - 1 : size_);
+
+            try
+            {
+                std::allocator_traits<Allocator>::construct(allocator_, slot, std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                std::allocator_traits<Allocator>::deallocate(allocator_, new_begin, new_capacity);
+                throw;
+            }
+
+            adopt_buffer(new_begin, new_capacity);
+            if (front)
+                head_ = new_capacity - 1;
+            ++size_;
+
+            return *slot;
+        }
+
+        void realloc(size_type new_capacity)
+        {
+            adopt_buffer(std::allocator_traits<Allocator>::allocate(allocator_, new_capacity), new_capacity);
+        }
+
+        // Relocates the elements to the front of the new buffer and frees the old one.
+        void adopt_buffer(T *new_begin, size_type new_capacity)
+        {
+            auto [first, second] = spans();
+
+            my_detail::relocate_n(allocator_, new_begin               , first.data() , first.size());
+            my_detail::relocate_n(allocator_, new_begin + first.size(), second.data(), second.size());
+
+            std::allocator_traits<Allocator>::deallocate(allocator_, begin_, capacity_);
+
+            begin_    = new_begin;
+            capacity_ = new_capacity;
+            head_     = 0;
+        }
+
+    // member data
+    private:
+        Allocator allocator_;
+
+        T        *begin_;
+        size_type capacity_;
+
+        // the elements are [head_, head_ + size_) modulo capacity_
+        size_type head_;
+        size_type size_;
+    };
+}
+
+#endif // RING_BUFFER_HPP
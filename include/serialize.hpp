@@ -0,0 +1,381 @@
+#ifndef SERIALIZE_HPP
+#define SERIALIZE_HPP
+
+#include <cstdint>
+#include <system_error>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "vector.hpp"
+
+//==================================================================================================
+
+// Binary format of a serialized vector: header (magic, element size, count), then the elements.
+// Trivially copyable elements are stored as raw bytes (element size = sizeof(T)), other ones are
+// stored by a user codec (element size = 0):
+//
+//     struct codec
+//     {
+//         void encode(my_std::binary_writer &writer, const T &elem);
+//         T    decode(my_std::binary_reader &reader);
+//     };
+//
+// Several vectors may follow each other in one file. The codec path reads ahead through a buffer,
+// the unused bytes are given back with lseek; on pipes and sockets, which can not seek, read all
+// the vectors through one binary_reader instead.
+
+namespace my_detail
+{
+    struct serialize_header_t
+    {
+        uint64_t magic;
+        uint64_t elem_size;
+        uint64_t count;
+    };
+
+    static constexpr uint64_t serialize_magic = 0x3152544345564d4dull; // "MMVECTR1"
+
+    //--------------------------------------------------------------------------------------------------
+
+    [[noreturn]] inline void throw_io_error(const char *what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    // Writes all the buffers, resuming after partial writes.
+    inline void write_all(int fd, iovec *iov, int iov_count)
+    {
+        while (iov_count > 0)
+        {
+            ssize_t written = ::writev(fd, iov, iov_count);
+            if (written == -1)
+            {
+                if (errno == EINTR) continue;
+                throw_io_error("serialize: writev");
+            }
+
+            for (; iov_count > 0 && static_cast<size_t>(written) >= iov->iov_len; ++iov, --iov_count)
+                written -= iov->iov_len;
+
+            if (iov_count > 0)
+            {
+                iov->iov_base = static_cast<char *>(iov->iov_base) + written;
+                iov->iov_len -= written;
+            }
+        }
+    }
+
+    inline void read_all(int fd, void *data, size_t size)
+    {
+        char *dst = static_cast<char *>(data);
+
+        while (size > 0)
+        {
+            ssize_t got = ::read(fd, dst, size);
+            if (got == -1)
+            {
+                if (errno == EINTR) continue;
+                throw_io_error("deserialize: read");
+            }
+            if (got == 0)
+            {
+                errno = EIO;
+                throw_io_error("deserialize: unexpected end of file");
+            }
+
+            dst  += got;
+            size -= got;
+        }
+    }
+
+    inline void check_header(const serialize_header_t &header, uint64_t elem_size)
+    {
+        if (header.magic != serialize_magic || header.elem_size != elem_size)
+        {
+            errno = EINVAL;
+            throw_io_error("deserialize: not a serialized vector of this element type");
+        }
+    }
+
+    // The count comes from the file: it must fit the vector and its bytes must fit size_t before
+    // anything is reserved for it. elem_size is 0 for codecs.
+    inline void check_count(const serialize_header_t &header, uint64_t elem_size, size_t max_size)
+    {
+        if (header.count > max_size || (elem_size != 0 && header.count > SIZE_MAX / elem_size))
+        {
+            errno = EINVAL;
+            throw_io_error("deserialize: stored count is too large");
+        }
+    }
+
+    inline serialize_header_t read_header(int fd, uint64_t elem_size)
+    {
+        serialize_header_t header = {};
+        read_all(fd, &header, sizeof(header));
+
+        check_header(header, elem_size);
+        return header;
+    }
+}
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace my_std
+{
+    // Buffered output of codecs. The bytes are written by flush(), the destructor flushes what is
+    // left only as a last resort and never throws: call flush() to see the write errors.
+    class binary_writer
+    {
+    // member functions
+    public:
+        explicit binary_writer(int fd):
+        fd_  (fd),
+        used_(0)
+        {}
+
+        binary_writer(const binary_writer &that) = delete;
+        binary_writer &operator =(const binary_writer &that) = delete;
+
+        ~binary_writer()
+        {
+            if (used_ == 0 || std::uncaught_exceptions() != 0)
+                return;
+
+            try
+            {
+                flush();
+            }
+            catch (...)
+            {}
+        }
+
+        void write(const void *data, size_t size)
+        {
+            if (used_ + size > buffer_size)
+                flush();
+
+            if (size >= buffer_size)
+            {
+                iovec iov = {const_cast<void *>(data), size};
+                my_detail::write_all(fd_, &iov, 1);
+                return;
+            }
+
+            std::memcpy(buffer_ + used_, data, size);
+            used_ += size;
+        }
+
+        template <class T>
+        void write(const T &value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            write(&value, sizeof(T));
+        }
+
+        void flush()
+        {
+            iovec iov = {buffer_, used_};
+            my_detail::write_all(fd_, &iov, 1);
+            used_ = 0;
+        }
+
+    // static data
+    private:
+        static constexpr size_t buffer_size = 64 * 1024;
+
+    // member data
+    private:
+        int    fd_;
+        size_t used_;
+        char   buffer_[buffer_size];
+    };
+
+    //--------------------------------------------------------------------------------------------------
+
+    // Buffered input of codecs. The destructor seeks the file back over the bytes read ahead, so
+    // the next reader of the fd starts right after the consumed ones.
+    class binary_reader
+    {
+    // member functions
+    public:
+        explicit binary_reader(int fd):
+        fd_  (fd),
+        pos_ (0),
+        size_(0)
+        {}
+
+        binary_reader(const binary_reader &that) = delete;
+        binary_reader &operator =(const binary_reader &that) = delete;
+
+        ~binary_reader()
+        {
+            // fails with ESPIPE on pipes, then the bytes read ahead are lost
+            if (pos_ != size_)
+                ::lseek(fd_, -static_cast<off_t>(size_ - pos_), SEEK_CUR);
+        }
+
+        void read(void *data, size_t size)
+        {
+            char *dst = static_cast<char *>(data);
+
+            size_t buffered = std::min(size, size_ - pos_);
+            std::memcpy(dst, buffer_ + pos_, buffered);
+            pos_ += buffered;
+            dst  += buffered;
+            size -= buffered;
+
+            if (size == 0)
+                return;
+
+            if (size >= buffer_size)
+            {
+                my_detail::read_all(fd_, dst, size);
+                return;
+            }
+
+            refill(size);
+            std::memcpy(dst, buffer_, size);
+            pos_ = size;
+        }
+
+        template <class T>
+        T read()
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            T value;
+            read(&value, sizeof(T));
+            return value;
+        }
+
+    private:
+        // Reads at least required bytes into the empty buffer.
+        void refill(size_t required)
+        {
+            pos_  = 0;
+            size_ = 0;
+
+            while (size_ < required)
+            {
+                ssize_t got = ::read(fd_, buffer_ + size_, buffer_size - size_);
+                if (got == -1)
+                {
+                    if (errno == EINTR) continue;
+                    my_detail::throw_io_error("deserialize: read");
+                }
+                if (got == 0)
+                {
+                    errno = EIO;
+                    my_detail::throw_io_error("deserialize: unexpected end of file");
+                }
+
+                size_ += got;
+            }
+        }
+
+    // static data
+    private:
+        static constexpr size_t buffer_size = 64 * 1024;
+
+    // member data
+    private:
+        int    fd_;
+        size_t pos_;
+        size_t size_;
+        char   buffer_[buffer_size];
+    };
+
+    //--------------------------------------------------------------------------------------------------
+
+    // Writes the header and the elements with a single writev.
+    template <class T, class Allocator, class GrowthPolicy, size_t N>
+    void serialize(int fd, const vector<T, Allocator, GrowthPolicy, N> &vec)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        my_detail::serialize_header_t header = {my_detail::serialize_magic, sizeof(T), vec.size()};
+
+        iovec iov[2] =
+        {
+            {&header, sizeof(header)},
+            {const_cast<T *>(vec.data()), vec.size() * sizeof(T)}
+        };
+        my_detail::write_all(fd, iov, 2);
+    }
+
+    // Reads exactly the header and the elements, straight into the vector storage allocated once.
+    // T must be trivially default constructible too: the storage is sized by resize_uninitialized.
+    template <class T, class Allocator, class GrowthPolicy, size_t N>
+    void deserialize(int fd, vector<T, Allocator, GrowthPolicy, N> &vec)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>);
+
+        my_detail::serialize_header_t header = my_detail::read_header(fd, sizeof(T));
+        my_detail::check_count(header, sizeof(T), vec.max_size());
+
+        vec.clear();
+        vec.reserve(header.count);
+        vec.resize_uninitialized(header.count);
+        my_detail::read_all(fd, vec.data(), header.count * sizeof(T));
+    }
+
+    // The same requirements on T as above.
+    template <class T, class Allocator, class GrowthPolicy, size_t N>
+    void deserialize(binary_reader &reader, vector<T, Allocator, GrowthPolicy, N> &vec)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>);
+
+        auto header = reader.read<my_detail::serialize_header_t>();
+        my_detail::check_header(header, sizeof(T));
+        my_detail::check_count (header, sizeof(T), vec.max_size());
+
+        vec.clear();
+        vec.reserve(header.count);
+        vec.resize_uninitialized(header.count);
+        reader.read(vec.data(), header.count * sizeof(T));
+    }
+
+    // Leaves the bytes in the writer, the caller flushes it.
+    template <class T, class Allocator, class GrowthPolicy, size_t N, class Codec>
+    void serialize(binary_writer &writer, const vector<T, Allocator, GrowthPolicy, N> &vec, Codec &codec)
+    {
+        writer.write(my_detail::serialize_header_t{my_detail::serialize_magic, 0, vec.size()});
+
+        for (const T &elem : vec)
+            codec.encode(writer, elem);
+    }
+
+    template <class T, class Allocator, class GrowthPolicy, size_t N, class Codec>
+    void serialize(int fd, const vector<T, Allocator, GrowthPolicy, N> &vec, Codec &codec)
+    {
+        binary_writer writer(fd);
+
+        serialize(writer, vec, codec);
+        writer.flush();
+    }
+
+    template <class T, class Allocator, class GrowthPolicy, size_t N, class Codec>
+    void deserialize(binary_reader &reader, vector<T, Allocator, GrowthPolicy, N> &vec, Codec &codec)
+    {
+        auto header = reader.read<my_detail::serialize_header_t>();
+        my_detail::check_header(header, 0);
+        my_detail::check_count (header, 0, vec.max_size());
+
+        vec.clear();
+        vec.reserve(header.count);
+
+        for (uint64_t idx = 0; idx < header.count; ++idx)
+            vec.push_back(codec.decode(reader));
+    }
+
+    // The bytes the reader takes past the vector are given back with lseek.
+    template <class T, class Allocator, class GrowthPolicy, size_t N, class Codec>
+    void deserialize(int fd, vector<T, Allocator, GrowthPolicy, N> &vec, Codec &codec)
+    {
+        binary_reader reader(fd);
+        deserialize(reader, vec, codec);
+    }
+}
+
+#endif // SERIALIZE_HPP
@@ -1,6 +1,7 @@
 #ifndef SHARED_PTR_HPP
 #define SHARED_PTR_HPP
 
+#include <atomic>
 #include <iostream>
 #include <type_traits>
 
@@ -25,6 +26,7 @@ namespace my_detail
     template <class T>
     using elem_t = std::remove_extent_t<T>;
 
+    // The count is atomic, so copies of one shared_ptr may be made and dropped in different threads.
     template <class T>
     class control_block_api
     {
@@ -37,13 +39,17 @@ namespace my_detail
         virtual ~control_block_api() {};
         virtual elem_t<T> *get_data() const = 0;
 
-        void   inc_cnt()       { cnt++; }
-        void   dec_cnt()       { cnt--; }
-        size_t get_cnt() const { return cnt; }
+        void inc_cnt() { cnt.fetch_add(1, std::memory_order_relaxed); }
+
+        // Returns the count left, the owner which gets 0 destroys the block.
+        size_t dec_cnt() { return cnt.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+
+        // Acquire: an owner seeing 1 also sees all the writes of the owners gone before.
+        size_t get_cnt() const { return cnt.load(std::memory_order_acquire); }
 
     // member data
     private:
-        size_t cnt;
+        std::atomic<size_t> cnt;
     };
 
     //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -73,7 +79,7 @@ namespace my_detail
     template <class... Args>
     single_control_block_t<T>::single_control_block_t(Args&&... args):
     control_block_api<T>(),
-    data(std::forward(args)...)
+    data(std::forward<Args>(args)...)
     {}
 
     //--------------------------------------------------------------------------------------------------
@@ -205,7 +211,7 @@ namespace my_std
     shared_ptr<T>::shared_ptr(const shared_ptr &that):
     data(that.data)
     {
-        data->inc_cnt();
+        if (data) data->inc_cnt();
     }
 
     //--------------------------------------------------------------------------------------------------
@@ -230,9 +236,8 @@ namespace my_std
     template <class T>
     shared_ptr<T> &shared_ptr<T>::operator =(const shared_ptr<T> &that)
     {
-        ~shared_ptr();
-        data = that.data;
-        data->inc_cnt();
+        shared_ptr copy(that);
+        std::swap(data, copy.data);
 
         return *this;
     }
@@ -253,8 +258,7 @@ namespace my_std
     {
         if (!data) return;
 
-        data->dec_cnt();
-        if (!data->get_cnt())
+        if (data->dec_cnt() == 0)
             delete data;
     }
 
@@ -332,7 +336,7 @@ namespace my_std
     {
         static_assert(!std::is_array_v<T>);
 
-        my_detail::single_control_block_t<T> *data = new my_detail::single_control_block_t<T>(std::forward(args)...);
+        my_detail::single_control_block_t<T> *data = new my_detail::single_control_block_t<T>(std::forward<Args>(args)...);
         return shared_ptr<T>(data);
     }
 }
@@ -0,0 +1,297 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86
+#endif
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#endif
+
+//==================================================================================================
+
+// Bulk kernels for arrays of trivially copyable elements. Copies go through memcpy, which glibc
+// already dispatches to the best vector unit at run time. Fills of non-zero values broadcast the
+// element to a 32 byte pattern and store it with AVX2 (chosen by cpuid) or SSE2, with a scalar
+// fallback for other architectures. Bit counts over word arrays use the popcnt instruction when
+// cpuid reports it.
+//
+// Copies larger than the streaming threshold (the last level cache size by default) bypass the
+// cache: the destination is written with non-temporal stores and the source is prefetched with
+// the NTA hint, so a huge copy does not evict the working set of the other threads.
+
+namespace my_detail
+{
+    namespace simd
+    {
+        static constexpr size_t pattern_size = 32;
+
+    #ifdef SIMD_X86
+        __attribute__((target("avx2")))
+        inline void fill_pattern_avx2(unsigned char *dst, size_t bytes, const unsigned char *pattern)
+        {
+            __m256i reg = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pattern));
+
+            for (; bytes >= 4 * pattern_size; bytes -= 4 * pattern_size, dst += 4 * pattern_size)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst                   ), reg);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst +     pattern_size), reg);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * pattern_size), reg);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 3 * pattern_size), reg);
+            }
+            for (; bytes >= pattern_size; bytes -= pattern_size, dst += pattern_size)
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), reg);
+
+            std::memcpy(dst, pattern, bytes);
+        }
+
+        inline void fill_pattern_sse2(unsigned char *dst, size_t bytes, const unsigned char *pattern)
+        {
+            __m128i reg = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pattern));
+
+            for (; bytes >= 4 * 16; bytes -= 4 * 16, dst += 4 * 16)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst     ), reg);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), reg);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 32), reg);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 48), reg);
+            }
+            for (; bytes >= 16; bytes -= 16, dst += 16)
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), reg);
+
+            std::memcpy(dst, pattern, bytes);
+        }
+
+        inline bool has_avx2()
+        {
+        #ifdef __AVX2__
+            return true;
+        #else
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        #endif
+        }
+
+        static constexpr size_t stream_prefetch_distance = 512;
+
+        __attribute__((target("avx2")))
+        inline void copy_stream_avx2(unsigned char *dst, const unsigned char *src, size_t bytes)
+        {
+            for (; bytes >= 4 * 32; bytes -= 4 * 32, dst += 4 * 32, src += 4 * 32)
+            {
+                _mm_prefetch(reinterpret_cast<const char *>(src + stream_prefetch_distance), _MM_HINT_NTA);
+
+                __m256i reg_0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src     ));
+                __m256i reg_1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 32));
+                __m256i reg_2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 64));
+                __m256i reg_3 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 96));
+
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(dst     ), reg_0);
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + 32), reg_1);
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + 64), reg_2);
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + 96), reg_3);
+            }
+            _mm_sfence();
+
+            std::memcpy(dst, src, bytes);
+        }
+
+        inline void copy_stream_sse2(unsigned char *dst, const unsigned char *src, size_t bytes)
+        {
+            for (; bytes >= 4 * 16; bytes -= 4 * 16, dst += 4 * 16, src += 4 * 16)
+            {
+                _mm_prefetch(reinterpret_cast<const char *>(src + stream_prefetch_distance), _MM_HINT_NTA);
+
+                __m128i reg_0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src     ));
+                __m128i reg_1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16));
+                __m128i reg_2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 32));
+                __m128i reg_3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 48));
+
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst     ), reg_0);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + 16), reg_1);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + 32), reg_2);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + 48), reg_3);
+            }
+            _mm_sfence();
+
+            std::memcpy(dst, src, bytes);
+        }
+
+        __attribute__((target("popcnt")))
+        inline size_t popcount_popcnt(const uint64_t *words, size_t count)
+        {
+            size_t ones = 0;
+            for (size_t idx = 0; idx < count; ++idx)
+                ones += __builtin_popcountll(words[idx]);
+
+            return ones;
+        }
+
+        inline bool has_popcnt()
+        {
+        #ifdef __POPCNT__
+            return true;
+        #else
+            static const bool supported = __builtin_cpu_supports("popcnt");
+            return supported;
+        #endif
+        }
+    #endif
+
+        // Fills bytes of dst with the periodic pattern (its period divides 16).
+        inline void fill_pattern(unsigned char *dst, size_t bytes, const unsigned char *pattern)
+        {
+        #ifdef SIMD_X86
+            if (has_avx2())
+                fill_pattern_avx2(dst, bytes, pattern);
+            else
+                fill_pattern_sse2(dst, bytes, pattern);
+        #else
+            for (; bytes >= pattern_size; bytes -= pattern_size, dst += pattern_size)
+                std::memcpy(dst, pattern, pattern_size);
+
+            std::memcpy(dst, pattern, bytes);
+        #endif
+        }
+
+        inline size_t detect_last_level_cache()
+        {
+            long size = 0;
+        #ifdef _SC_LEVEL3_CACHE_SIZE
+            size = ::sysconf(_SC_LEVEL3_CACHE_SIZE);
+        #endif
+        #ifdef _SC_LEVEL2_CACHE_SIZE
+            if (size <= 0)
+                size = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+        #endif
+            return size > 0 ? size : 8 * 1024 * 1024;
+        }
+
+        inline std::atomic<size_t> &streaming_threshold_storage()
+        {
+            static std::atomic<size_t> threshold(detect_last_level_cache());
+            return threshold;
+        }
+
+        // Copies the bytes with non-temporal stores, the destination is aligned first.
+        inline void copy_stream(unsigned char *dst, const unsigned char *src, size_t bytes)
+        {
+        #ifdef SIMD_X86
+            size_t head = std::min(bytes, (32 - reinterpret_cast<uintptr_t>(dst) % 32) % 32);
+            std::memcpy(dst, src, head);
+
+            if (has_avx2())
+                copy_stream_avx2(dst + head, src + head, bytes - head);
+            else
+                copy_stream_sse2(dst + head, src + head, bytes - head);
+        #else
+            std::memcpy(dst, src, bytes);
+        #endif
+        }
+
+        // Number of set bits in the words.
+        inline size_t popcount(const uint64_t *words, size_t count)
+        {
+        #ifdef SIMD_X86
+            if (has_popcnt())
+                return popcount_popcnt(words, count);
+        #endif
+            size_t ones = 0;
+            for (size_t idx = 0; idx < count; ++idx)
+                ones += std::popcount(words[idx]);
+
+            return ones;
+        }
+
+        inline bool is_zero(const unsigned char *bytes, size_t size)
+        {
+            for (size_t idx = 0; idx < size; ++idx)
+                if (bytes[idx] != 0) return false;
+
+            return true;
+        }
+    }
+
+    //--------------------------------------------------------------------------------------------------
+
+    // Copies of at least this many bytes bypass the cache. Set it to SIZE_MAX to turn streaming off.
+    inline size_t streaming_threshold()
+    {
+        return simd::streaming_threshold_storage().load(std::memory_order_relaxed);
+    }
+
+    inline void set_streaming_threshold(size_t bytes)
+    {
+        simd::streaming_threshold_storage().store(bytes, std::memory_order_relaxed);
+    }
+
+    inline void copy_bytes(void *dst, const void *src, size_t bytes)
+    {
+        if (bytes >= streaming_threshold())
+            simd::copy_stream(static_cast<unsigned char *>(dst), static_cast<const unsigned char *>(src), bytes);
+        else
+            std::memcpy(dst, src, bytes);
+    }
+
+    template <class T>
+    void fill_n(T *dst, size_t count, const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        if (count == 0)
+            return;
+
+        const unsigned char *value_bytes = reinterpret_cast<const unsigned char *>(&value);
+
+        // also covers value initialization of arithmetic types and pointers
+        if (sizeof(T) == 1 || simd::is_zero(value_bytes, sizeof(T)))
+        {
+            std::memset(static_cast<void *>(dst), value_bytes[0], count * sizeof(T));
+            return;
+        }
+
+        if constexpr (16 % sizeof(T) == 0)
+        {
+            unsigned char pattern[simd::pattern_size];
+            for (size_t offset = 0; offset < simd::pattern_size; offset += sizeof(T))
+                std::memcpy(pattern + offset, value_bytes, sizeof(T));
+
+            simd::fill_pattern(reinterpret_cast<unsigned char *>(dst), count * sizeof(T), pattern);
+        }
+        else
+        {
+            // doubling copies of the already filled prefix
+            std::memcpy(static_cast<void *>(dst), value_bytes, sizeof(T));
+
+            for (size_t filled = 1; filled < count; filled *= 2)
+                std::memcpy(static_cast<void *>(dst + filled), dst, std::min(filled, count - filled) * sizeof(T));
+        }
+    }
+
+    template <class T>
+    void copy_n(T *dst, const T *src, size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        if (count == 0)
+            return;
+
+        copy_bytes(static_cast<void *>(dst), src, count * sizeof(T));
+    }
+}
+
+//==================================================================================================
+
+#undef SIMD_X86
+
+#endif // SIMD_HPP
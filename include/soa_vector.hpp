@@ -0,0 +1,337 @@
+#ifndef SOA_VECTOR_HPP
+#define SOA_VECTOR_HPP
+
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+
+#include "vector.hpp"
+
+//==================================================================================================
+
+namespace my_std
+{
+    // Structure of arrays: every field Ts[i] is kept in its own contiguous column, so a loop over
+    // one field reads only that field. All the columns share one capacity and live in one block.
+    // Growth follows GrowthPolicy as in vector, columns of trivially relocatable fields are moved
+    // with memcpy.
+    //
+    // A row is accessed through the proxy reference std::tuple<Ts&...>.
+    template <class GrowthPolicy, class... Ts>
+    class basic_soa_vector
+    {
+    // assert
+        static_assert(sizeof...(Ts) != 0);
+
+    // types
+    public:
+        using value_type      = std::tuple<Ts...>;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using reference       = std::tuple<Ts&...>;
+        using const_reference = std::tuple<const Ts&...>;
+
+        template <size_t I>
+        using column_type = std::tuple_element_t<I, value_type>;
+
+        using iterator       = my_detail::indexed_iterator<      basic_soa_vector,       reference>;
+        using const_iterator = my_detail::indexed_iterator<const basic_soa_vector, const_reference>;
+
+    // member functions
+    public:
+        basic_soa_vector():
+        block_   (nullptr),
+        columns_ (),
+        size_    (0),
+        capacity_(0)
+        {}
+
+        explicit basic_soa_vector(size_type count):
+        basic_soa_vector()
+        {
+            resize(count);
+        }
+
+        basic_soa_vector(const basic_soa_vector &that):
+        basic_soa_vector()
+        {
+            reserve(that.size());
+            for (size_type idx = 0; idx < that.size(); ++idx)
+                std::apply([this](const Ts &... fields) { emplace_back(fields...); }, that[idx]);
+        }
+
+        basic_soa_vector(basic_soa_vector &&that):
+        basic_soa_vector()
+        {
+            swap(that);
+        }
+
+        ~basic_soa_vector()
+        {
+            clear();
+            ::operator delete(block_, std::align_val_t(block_alignment));
+        }
+
+        basic_soa_vector &operator =(basic_soa_vector that)
+        {
+            swap(that);
+            return *this;
+        }
+
+        void swap(basic_soa_vector &that)
+        {
+            std::swap(block_   , that.block_);
+            std::swap(columns_ , that.columns_);
+            std::swap(size_    , that.size_);
+            std::swap(capacity_, that.capacity_);
+        }
+
+        reference operator [](size_type pos)
+        {
+            assert(pos < size());
+            return row<reference>(pos, indices());
+        }
+
+        const_reference operator [](size_type pos) const
+        {
+            assert(pos < size());
+            return row<const_reference>(pos, indices());
+        }
+
+        // The I-th field of all the rows.
+        template <size_t I>
+        std::span<column_type<I>> column()
+        {
+            return std::span<column_type<I>>(std::get<I>(columns_), size_);
+        }
+
+        template <size_t I>
+        std::span<const column_type<I>> column() const
+        {
+            return std::span<const column_type<I>>(std::get<I>(columns_), size_);
+        }
+
+        inline iterator        begin()       { return iterator(this, 0); }
+        inline const_iterator  begin() const { return const_iterator(this, 0); }
+        inline const_iterator cbegin() const { return const_iterator(this, 0); }
+
+        inline iterator        end()       { return iterator(this, size()); }
+        inline const_iterator  end() const { return const_iterator(this, size()); }
+        inline const_iterator cend() const { return const_iterator(this, size()); }
+
+        inline bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        inline size_type size() const
+        {
+            return size_;
+        }
+
+        inline size_type capacity() const
+        {
+            return capacity_;
+        }
+
+        void reserve(size_type new_capacity)
+        {
+            if (new_capacity > capacity_)
+                realloc(GrowthPolicy::fit(new_capacity, row_size));
+        }
+
+        void clear()
+        {
+            [&]<size_t... I>(std::index_sequence<I...>)
+            {
+                (destroy_column(std::get<I>(columns_), size_), ...);
+            }(indices());
+
+            size_ = 0;
+        }
+
+        void resize(size_type count)
+        {
+            reserve(count);
+
+            while (size_ > count)
+                pop_back();
+            while (size_ < count)
+                emplace_back(Ts()...);
+        }
+
+        void push_back(const Ts &... fields)
+        {
+            emplace_back(fields...);
+        }
+
+        // Constructs the I-th field of the new row from the I-th argument.
+        template <class... Args>
+        reference emplace_back(Args&&... args)
+        {
+            static_assert(sizeof...(Args) == column_count);
+
+            if (size_ < capacity_)
+            {
+                construct_row(columns_, size_, std::forward<Args>(args)...);
+                ++size_;
+                return (*this)[size_ - 1];
+            }
+
+            // the new row goes first: args may refer to the old rows
+            size_type new_capacity = GrowthPolicy::grow(capacity_, size_ + 1, row_size);
+            void     *new_block    = allocate_block(new_capacity);
+            columns_t new_columns  = make_columns(new_block, new_capacity);
+
+            try
+            {
+                construct_row(new_columns, size_, std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                ::operator delete(new_block, std::align_val_t(block_alignment));
+                throw;
+            }
+
+            adopt_block(new_block, new_columns, new_capacity);
+            ++size_;
+            return (*this)[size_ - 1];
+        }
+
+        void pop_back()
+        {
+            assert(!empty());
+
+            --size_;
+            destroy_row(columns_, size_, column_count);
+        }
+
+    private:
+        using columns_t = std::tuple<Ts *...>;
+        using indices   = std::index_sequence_for<Ts...>;
+
+        template <class Reference, size_t... I>
+        Reference row(size_type idx, std::index_sequence<I...>) const
+        {
+            return Reference(std::get<I>(columns_)[idx]...);
+        }
+
+        // Constructs the fields one by one, the constructed ones are destroyed if one throws.
+        template <class... Args>
+        void construct_row(const columns_t &columns, size_type idx, Args&&... args)
+        {
+            size_t constructed = 0;
+            try
+            {
+                [&]<size_t... I>(std::index_sequence<I...>)
+                {
+                    ((std::construct_at(std::get<I>(columns) + idx, std::forward<Args>(args)), ++constructed), ...);
+                }(indices());
+            }
+            catch (...)
+            {
+                destroy_row(columns, idx, constructed);
+                throw;
+            }
+        }
+
+        // Destroys the first count fields of the row.
+        static void destroy_row(const columns_t &columns, size_type idx, size_t count)
+        {
+            [&]<size_t... I>(std::index_sequence<I...>)
+            {
+                ((I < count ? std::destroy_at(std::get<I>(columns) + idx) : void()), ...);
+            }(indices());
+        }
+
+        void realloc(size_type new_capacity)
+        {
+            void *new_block = allocate_block(new_capacity);
+            adopt_block(new_block, make_columns(new_block, new_capacity), new_capacity);
+        }
+
+        // Relocates the rows to the new block and frees the old one.
+        void adopt_block(void *new_block, const columns_t &new_columns, size_type new_capacity)
+        {
+            [&]<size_t... I>(std::index_sequence<I...>)
+            {
+                (relocate_column(std::get<I>(new_columns), std::get<I>(columns_), size_), ...);
+            }(indices());
+
+            ::operator delete(block_, std::align_val_t(block_alignment));
+
+            block_    = new_block;
+            columns_  = new_columns;
+            capacity_ = new_capacity;
+        }
+
+    // static functions
+    private:
+        template <class T>
+        static void relocate_column(T *dst, T *src, size_type count)
+        {
+            std::allocator<T> allocator;
+            my_detail::relocate_n(allocator, dst, src, count);
+        }
+
+        template <class T>
+        static void destroy_column(T *first, size_type count)
+        {
+            std::allocator<T> allocator;
+            my_detail::destroy_n(allocator, first, count);
+        }
+
+        // Columns follow each other in the block, each one aligned for its type.
+        static size_t column_offset(size_t column, size_type capacity)
+        {
+            size_t offset = 0;
+            for (size_t idx = 0; idx < column; ++idx)
+            {
+                offset += capacity * column_sizes[idx];
+                offset  = (offset + column_alignments[idx + 1] - 1) / column_alignments[idx + 1] * column_alignments[idx + 1];
+            }
+            return offset;
+        }
+
+        static void *allocate_block(size_type capacity)
+        {
+            if (capacity > SIZE_MAX / 2 / row_size)
+                throw std::bad_array_new_length();
+
+            return ::operator new(column_offset(column_count, capacity), std::align_val_t(block_alignment));
+        }
+
+        static columns_t make_columns(void *block, size_type capacity)
+        {
+            return [&]<size_t... I>(std::index_sequence<I...>)
+            {
+                return columns_t(reinterpret_cast<Ts *>(static_cast<char *>(block) + column_offset(I, capacity))...);
+            }(indices());
+        }
+
+    // static data
+    private:
+        static constexpr size_t column_count = sizeof...(Ts);
+        static constexpr size_t row_size     = (sizeof(Ts) + ...);
+
+        static constexpr size_t column_sizes     [column_count + 1] = {sizeof (Ts)..., 0};
+        static constexpr size_t column_alignments[column_count + 1] = {alignof(Ts)..., 1};
+
+        static constexpr size_t block_alignment = std::max({alignof(std::max_align_t), alignof(Ts)...});
+
+    // member data
+    private:
+        void     *block_;
+        columns_t columns_;
+        size_type size_;
+        size_type capacity_;
+    };
+
+    //--------------------------------------------------------------------------------------------------
+
+    template <class... Ts>
+    using soa_vector = basic_soa_vector<growth_x2, Ts...>;
+}
+
+#endif // SOA_VECTOR_HPP
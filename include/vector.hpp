@@ -3,6 +3,17 @@
 
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <functional>
+#include <cstring>
+#include <cstdlib>
+#include <type_traits>
+#include <iterator>
+#include <ranges>
+#include <span>
+
+#include "simd.hpp"
+#include "parallel.hpp"
 
 #define VERIFICATION_TEMPLATE_CLASS_INPUT_IT    \
 template <                                      \
@@ -10,17 +21,316 @@ template <                                      \
     class = std::enable_if_t<                   \
             std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>>>
 
-#define VERIFICATION_TEMPLATE_CLASS_BIDIRECT_IT \
-template <                                      \
-    class BidirectIt,                           \
-    class = std::enable_if_t<                   \
-            std::is_base_of_v<std::bidirectional_iterator_tag, typename std::iterator_traits<BidirectIt>::iterator_category>>>
-
 //==================================================================================================
 
 namespace my_std
 {
-    template <class T, class Allocator = std::allocator<T>>
+    // Trait for types whose objects can be moved to another address by copying their bytes
+    // (the source is not destroyed afterwards). Specialize it for such user types to opt in.
+    template <class T>
+    struct is_trivially_relocatable: std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+    template <class T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+}
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace my_detail
+{
+    template <class Allocator, class T, class = void>
+    struct has_construct: std::false_type {};
+
+    template <class Allocator, class T>
+    struct has_construct<Allocator, T,
+        std::void_t<decltype(std::declval<Allocator&>().construct(std::declval<T*>(), std::declval<T&&>()))>>:
+        std::true_type {};
+
+    template <class Allocator, class T, class = void>
+    struct has_destroy: std::false_type {};
+
+    template <class Allocator, class T>
+    struct has_destroy<Allocator, T,
+        std::void_t<decltype(std::declval<Allocator&>().destroy(std::declval<T*>()))>>:
+        std::true_type {};
+
+    template <class Allocator, class T, class = void>
+    struct has_reallocate: std::false_type {};
+
+    template <class Allocator, class T>
+    struct has_reallocate<Allocator, T,
+        std::void_t<decltype(std::declval<Allocator&>().reallocate(
+            std::declval<T*>(), std::declval<size_t>(), std::declval<size_t>()))>>:
+        std::true_type {};
+
+    // Raw inline buffer of small_vector. Empty for ordinary vectors. The constructor leaves the
+    // bytes uninitialized on purpose, it only makes the buffer a constructed member before the
+    // vector takes its address.
+    template <class T, size_t Capacity>
+    struct inline_storage
+    {
+        inline_storage() {}
+
+        T *get() { return reinterpret_cast<T *>(data); }
+
+        alignas(T) unsigned char data[Capacity * sizeof(T)];
+    };
+
+    template <class T>
+    struct inline_storage<T, 0>
+    {
+        T *get() { return nullptr; }
+    };
+
+    // Elements may be relocated with memcpy only if the allocator does not hook construct/destroy.
+    template <class T, class Allocator>
+    inline constexpr bool is_relocatable_by_memcpy_v =
+        my_std::is_trivially_relocatable_v<T> &&
+        !has_construct<Allocator, T>::value   &&
+        !has_destroy  <Allocator, T>::value;
+
+    // Elements may be copy constructed with memcpy/memset only if the allocator does not hook construct.
+    template <class T, class Allocator>
+    inline constexpr bool is_constructible_by_memcpy_v =
+        std::is_trivially_copyable_v<T> &&
+        !has_construct<Allocator, T>::value;
+
+    //--------------------------------------------------------------------------------------------------
+
+    // Raw memory helpers shared by the containers built next to vector.
+
+    template <class Allocator, class T>
+    void destroy_n(Allocator &allocator, T *first, size_t count)
+    {
+        if constexpr (std::is_trivially_destructible_v<T> && !has_destroy<Allocator, T>::value)
+            return;
+
+        for (T *last = first + count; first != last; ++first)
+            std::allocator_traits<Allocator>::destroy(allocator, first);
+    }
+
+    // Moves count elements from src to the uninitialized dst and ends the lifetime of the source.
+    // The ranges must not overlap.
+    template <class Allocator, class T>
+    void relocate_n(Allocator &allocator, T *dst, T *src, size_t count)
+    {
+        if (count == 0)
+            return;
+
+        if constexpr (is_relocatable_by_memcpy_v<T, Allocator>)
+        {
+            copy_bytes(static_cast<void *>(dst), src, count * sizeof(T));
+        }
+        else
+        {
+            for (T *last = src + count; src != last; ++src, ++dst)
+            {
+                std::allocator_traits<Allocator>::construct(allocator, dst, std::move(*src));
+                std::allocator_traits<Allocator>::destroy(allocator, src);
+            }
+        }
+    }
+
+    // The same for dst below src, where [dst, src) is uninitialized and the ranges may overlap:
+    // every destroyed source becomes the uninitialized destination of a later element.
+    template <class Allocator, class T>
+    void relocate_down(Allocator &allocator, T *dst, T *src, size_t count)
+    {
+        assert(dst <= src);
+
+        if (dst == src || count == 0)
+            return;
+
+        if constexpr (is_relocatable_by_memcpy_v<T, Allocator>)
+            std::memmove(static_cast<void *>(dst), src, count * sizeof(T));
+        else
+            relocate_n(allocator, dst, src, count);
+    }
+
+    //--------------------------------------------------------------------------------------------------
+
+    // Accesses element idx of the container for indexed_iterator.
+    struct subscript_access
+    {
+        template <class Container>
+        static decltype(auto) get(Container &container, size_t idx)
+        {
+            return container[idx];
+        }
+    };
+
+    // Random access iterator over the positions [0, size()) of a Container whose elements are not
+    // one contiguous array. Ref is the type of *it: a plain reference, or a proxy object for
+    // containers that do not store value_type objects (bit_vector, soa_vector, flat_map). Proxy
+    // iterators are random access only in the C++20 sense: the legacy category requires *it to be
+    // a real reference, so they report input_iterator_tag to the C++17 algorithms.
+    template <class Container, class Ref, class Access = subscript_access>
+    class indexed_iterator
+    {
+    // types
+    private:
+        static constexpr bool is_proxy = !std::is_reference_v<Ref>;
+
+        // it->member on a proxy reference
+        struct arrow_proxy
+        {
+            Ref ref;
+
+            Ref *operator ->() { return &ref; }
+        };
+
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::conditional_t<is_proxy, std::input_iterator_tag, std::random_access_iterator_tag>;
+        using value_type        = typename std::remove_const_t<Container>::value_type;
+        using difference_type   = ptrdiff_t;
+        using pointer           = std::conditional_t<is_proxy, arrow_proxy, std::remove_reference_t<Ref> *>;
+        using reference         = Ref;
+
+    // member functions
+    public:
+        indexed_iterator(Container *container = nullptr, size_t idx = 0):
+        container_(container),
+        idx_      (idx)
+        {}
+
+        reference operator *() const
+        {
+            return Access::get(*container_, idx_);
+        }
+
+        pointer operator ->() const
+        {
+            if constexpr (is_proxy)
+                return pointer{**this};
+            else
+                return std::addressof(**this);
+        }
+
+        indexed_iterator &operator++()    { ++idx_; return *this; }
+        indexed_iterator  operator++(int) { return indexed_iterator(container_, idx_++); }
+
+        indexed_iterator &operator--()    { --idx_; return *this; }
+        indexed_iterator  operator--(int) { return indexed_iterator(container_, idx_--); }
+
+        indexed_iterator operator +(difference_type delta) const { return indexed_iterator(container_, idx_ + delta); }
+        indexed_iterator operator -(difference_type delta) const { return indexed_iterator(container_, idx_ - delta); }
+
+        friend indexed_iterator operator +(difference_type delta, const indexed_iterator &self)
+        {
+            return self + delta;
+        }
+
+        indexed_iterator &operator +=(difference_type delta) { idx_ += delta; return *this; }
+        indexed_iterator &operator -=(difference_type delta) { idx_ -= delta; return *this; }
+
+        difference_type operator -(const indexed_iterator &that) const
+        {
+            return static_cast<difference_type>(idx_) - static_cast<difference_type>(that.idx_);
+        }
+
+        bool operator ==(const indexed_iterator &that) const
+        {
+            return idx_ == that.idx_;
+        }
+
+        auto operator <=>(const indexed_iterator &that) const
+        {
+            return idx_ <=> that.idx_;
+        }
+
+        reference operator [](difference_type delta) const
+        {
+            return Access::get(*container_, idx_ + delta);
+        }
+
+        size_t index() const
+        {
+            return idx_;
+        }
+
+    // member data
+    private:
+        Container *container_;
+        size_t     idx_;
+    };
+}
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace my_std
+{
+    // Growth policies decide the capacity of the new buffer:
+    //   grow(capacity, required, elem_size) - on implicit growth (push_back, insert, resize)
+    //   fit (          required, elem_size) - on explicit reserve()
+    // Both return a capacity not less than required.
+
+    template <size_t Numerator, size_t Denominator, size_t InitialCapacity = 4>
+    struct growth_factor
+    {
+        static_assert(Numerator > Denominator);
+
+        static size_t grow(size_t capacity, size_t required, size_t)
+        {
+            size_t new_capacity = (capacity == 0) ? InitialCapacity : capacity * Numerator / Denominator;
+            return std::max({new_capacity, capacity + 1, required});
+        }
+
+        static size_t fit(size_t required, size_t)
+        {
+            return required;
+        }
+    };
+
+    using growth_x2   = growth_factor<2, 1>;
+    using growth_x1_5 = growth_factor<3, 2>;
+
+    // Rounds capacities of Base up to the size class malloc really hands out, so the slack of the
+    // bin becomes usable capacity instead of being wasted. The classes are computed from the glibc
+    // malloc layout (16 byte granules with an 8 byte header, whole pages above the mmap threshold)
+    // without calling malloc, so the policy only fits malloc-backed allocators such as
+    // std::allocator and malloc_allocator.
+    template <class Base = growth_x2>
+    struct growth_size_class
+    {
+        static size_t grow(size_t capacity, size_t required, size_t elem_size)
+        {
+            return round_up(Base::grow(capacity, required, elem_size), elem_size);
+        }
+
+        static size_t fit(size_t required, size_t elem_size)
+        {
+            return round_up(Base::fit(required, elem_size), elem_size);
+        }
+
+    private:
+        static size_t round_up(size_t count, size_t elem_size)
+        {
+            if (count == 0 || count > SIZE_MAX / 2 / elem_size)
+                return count;
+
+            size_t bytes  = count * elem_size;
+            size_t usable = 0;
+
+            if (bytes + chunk_header < mmap_threshold)
+                usable = std::max(min_chunk, (bytes + chunk_header + granule - 1) / granule * granule) - chunk_header;
+            else
+                usable = (bytes + 2 * chunk_header + page_size - 1) / page_size * page_size - 2 * chunk_header;
+
+            return std::max(count, usable / elem_size);
+        }
+
+        static constexpr size_t chunk_header   = sizeof(size_t);
+        static constexpr size_t granule        = 2 * sizeof(size_t);
+        static constexpr size_t min_chunk      = 4 * sizeof(size_t);
+        static constexpr size_t mmap_threshold = 128 * 1024;
+        static constexpr size_t page_size      = 4096;
+    };
+
+    //--------------------------------------------------------------------------------------------------
+
+    // InlineCapacity elements are stored inside the object itself, the heap is used only for more.
+    template <class T, class Allocator = std::allocator<T>, class GrowthPolicy = growth_x2, size_t InlineCapacity = 0>
     class vector
     {
     // types
@@ -34,65 +344,77 @@ namespace my_std
         using pointer         = typename std::allocator_traits<Allocator>::pointer;
         using const_pointer   = typename std::allocator_traits<Allocator>::const_pointer;
 
-        class iterator
+        // Iterator over Value (T or const T), a thin wrapper around the raw pointer.
+        template <class Value>
+        class basic_iterator
         {
         // types
         public:
+            using iterator_concept  = std::contiguous_iterator_tag;
             using iterator_category = std::random_access_iterator_tag;
-            using value_type        = T;
+            using value_type        = std::remove_cv_t<Value>;
             using difference_type   = ptrdiff_t;
-            using pointer           = T*;
-            using reference         = T&;
+            using pointer           = Value*;
+            using reference         = Value&;
 
         // member functions
         public:
-            iterator(pointer value = nullptr):
+            basic_iterator(pointer value = nullptr):
             value_(value)
             {}
 
-            iterator(const iterator &that):
-            value_(that.value_)
+            // iterator -> const_iterator
+            template <class Other, class = std::enable_if_t<std::is_convertible_v<Other *, pointer>>>
+            basic_iterator(const basic_iterator<Other> &that):
+            value_(that.get_ptr())
             {}
 
-            iterator &operator =(const iterator &that)
+            reference operator *() const
             {
-                value_ = that.value_;
-                return *this;
+                return *value_;
             }
 
-            reference operator *() const
+            pointer operator ->() const
             {
-                return *value_;
+                return value_;
             }
 
-            iterator &operator++()    { ++value_; return *this; }
-            iterator &operator++(int) { value_++; return *this; }
+            basic_iterator &operator++()    { ++value_; return *this; }
+            basic_iterator  operator++(int) { return basic_iterator(value_++); }
 
-            iterator &operator--()    { --value_; return *this; }
-            iterator &operator--(int) { value_--; return *this; }
+            basic_iterator &operator--()    { --value_; return *this; }
+            basic_iterator  operator--(int) { return basic_iterator(value_--); }
 
-            iterator operator +(long delta) const { return iterator(value_ + delta); }
-            iterator operator -(long delta) const { return iterator(value_ - delta); }
+            basic_iterator operator +(difference_type delta) const { return basic_iterator(value_ + delta); }
+            basic_iterator operator -(difference_type delta) const { return basic_iterator(value_ - delta); }
 
-            iterator &operator +=(long delta) { value_ += delta; return *this; }
-            iterator &operator -=(long delta) { value_ -= delta; return *this; }
+            friend basic_iterator operator +(difference_type delta, const basic_iterator &self)
+            {
+                return self + delta;
+            }
 
-            difference_type operator -(const iterator &that) const
+            basic_iterator &operator +=(difference_type delta) { value_ += delta; return *this; }
+            basic_iterator &operator -=(difference_type delta) { value_ -= delta; return *this; }
+
+            template <class Other>
+            difference_type operator -(const basic_iterator<Other> &that) const
             {
-                return value_ - that.value_;
+                return value_ - that.get_ptr();
             }
 
-            bool operator ==(const iterator &that) const
+            template <class Other>
+            bool operator ==(const basic_iterator<Other> &that) const
             {
-                return value_ == that.value_;
+                return value_ == that.get_ptr();
             }
 
-            auto operator <=>(const iterator &that) const
+            template <class Other>
+            auto operator <=>(const basic_iterator<Other> &that) const
             {
-                return value_ <=> that.value_;
+                return static_cast<const T *>(value_) <=> static_cast<const T *>(that.get_ptr());
             }
 
-            value_type operator [](size_type idx) const
+            reference operator [](difference_type idx) const
             {
                 return value_[idx];
             }
@@ -107,7 +429,8 @@ namespace my_std
             pointer value_;
         };
 
-        using const_iterator = const iterator;
+        using iterator       = basic_iterator<T>;
+        using const_iterator = basic_iterator<const T>;
 
     // friends
 
@@ -129,23 +452,23 @@ namespace my_std
     public:
         vector():
         allocator_   (),
-        begin_       (nullptr),
-        end_size_    (nullptr),
-        end_capacity_(nullptr)
+        begin_       (inline_.get()),
+        end_size_    (begin_),
+        end_capacity_(begin_ + InlineCapacity)
         {}
 
         explicit vector(const Allocator &allocator):
         allocator_   (allocator),
-        begin_       (nullptr),
-        end_size_    (nullptr),
-        end_capacity_(nullptr)
+        begin_       (inline_.get()),
+        end_size_    (begin_),
+        end_capacity_(begin_ + InlineCapacity)
         {}
 
         explicit vector(size_type count, const_reference value, const Allocator &allocator = Allocator()):
         allocator_   (allocator),
-        begin_       (std::allocator_traits<Allocator>::allocate(allocator_, count)),
+        begin_       (allocate_storage(count)),
         end_size_    (begin_ + count),
-        end_capacity_(end_size_)
+        end_capacity_(begin_ + storage_capacity(count))
         {
             copy_construct(begin_, end_size_, value);
         }
@@ -154,67 +477,125 @@ namespace my_std
         vector(count, T(), allocator)
         {}
 
+        // Forward ranges are measured once and allocated exactly, single pass input ranges
+        // stream in with the geometric growth.
         VERIFICATION_TEMPLATE_CLASS_INPUT_IT
         explicit vector(InputIt first, InputIt last, const Allocator &allocator = Allocator()):
-        allocator_   (allocator),
-        begin_       (std::allocator_traits<Allocator>::allocate(allocator_, std::distance(first, last))),
-        end_size_    (begin_ + std::distance(first, last)),
-        end_capacity_(end_size_)
+        vector(allocator)
         {
-            copy_construct(begin_, first, last);
+            if constexpr (!is_forward_source_v<InputIt>)
+            {
+                append_input(first, last);
+            }
+            else
+            {
+                size_type count = std::distance(first, last);
+
+                begin_        = allocate_storage(count);
+                end_size_     = begin_ + count;
+                end_capacity_ = begin_ + storage_capacity(count);
+
+                copy_construct(begin_, first, last);
+            }
         }
 
         vector(const vector &that):
-        allocator_   (that.allocator_),
-        begin_       (std::allocator_traits<Allocator>::allocate(allocator_, that.capacity())),
+        allocator_   (std::allocator_traits<Allocator>::select_on_container_copy_construction(that.allocator_)),
+        begin_       (allocate_storage(that.capacity())),
         end_size_    (begin_ + that.size()),
-        end_capacity_(begin_ + that.capacity())
+        end_capacity_(begin_ + storage_capacity(that.capacity()))
         {
             copy_construct(begin_, that.begin_, that.end_size_);
         }
 
         explicit vector(const vector &that, const Allocator &allocator):
         allocator_   (allocator),
-        begin_       (std::allocator_traits<Allocator>::allocate(allocator_, that.capacity())),
+        begin_       (allocate_storage(that.capacity())),
         end_size_    (begin_ + that.size()),
-        end_capacity_(begin_ + that.capacity())
+        end_capacity_(begin_ + storage_capacity(that.capacity()))
         {
             copy_construct(begin_, that.begin_, that.end_size_);
         }
 
         vector(vector &&that):
         allocator_   (std::move(that.allocator_)),
-        begin_       (that.begin_),
-        end_size_    (that.end_size_),
-        end_capacity_(that.end_capacity_)
+        begin_       (inline_.get()),
+        end_size_    (begin_),
+        end_capacity_(begin_ + InlineCapacity)
         {
-            that.begin_        = nullptr;
-            that.end_size_     = nullptr;
-            that.end_capacity_ = nullptr;
+            steal_storage(that);
         }
 
         explicit vector(vector &&that, const Allocator &allocator):
         allocator_   (allocator),
-        begin_       (std::allocator_traits<Allocator>::allocate(allocator_, that.capacity())),
-        end_size_    (begin_ + that.size()),
-        end_capacity_(begin_ + that.capacity())
+        begin_       (inline_.get()),
+        end_size_    (begin_),
+        end_capacity_(begin_ + InlineCapacity)
         {
+            if (allocator_ == that.allocator_)
+            {
+                steal_storage(that);
+                return;
+            }
+
+            begin_        = allocate_storage(that.capacity());
+            end_size_     = begin_ + that.size();
+            end_capacity_ = begin_ + storage_capacity(that.capacity());
+
             move_construct(begin_, that.begin_, that.end_size_);
         }
 
         explicit vector(std::initializer_list<T> init_list, const Allocator &allocator = Allocator()):
         allocator_   (allocator),
-        begin_       (std::allocator_traits<Allocator>::allocate(allocator_, init_list.size())),
+        begin_       (allocate_storage(init_list.size())),
         end_size_    (begin_ + init_list.size()),
-        end_capacity_(end_size_)
+        end_capacity_(begin_ + storage_capacity(init_list.size()))
         {
             copy_construct(begin_, init_list.begin(), init_list.end());
         }
 
+        // Parallel versions of the bulk constructors, see parallel_policy.
+        explicit vector(const parallel_policy &policy, size_type count, const_reference value,
+                        const Allocator &allocator = Allocator()):
+        allocator_   (allocator),
+        begin_       (allocate_storage(count)),
+        end_size_    (begin_),
+        end_capacity_(begin_ + storage_capacity(count))
+        {
+            try
+            {
+                parallel_fill(policy, begin_, count, value);
+            }
+            catch (...)
+            {
+                deallocate_storage(begin_.get_ptr(), capacity());
+                throw;
+            }
+            end_size_ = begin_ + count;
+        }
+
+        vector(const parallel_policy &policy, const vector &that):
+        allocator_   (std::allocator_traits<Allocator>::select_on_container_copy_construction(that.allocator_)),
+        begin_       (allocate_storage(that.capacity())),
+        end_size_    (begin_),
+        end_capacity_(begin_ + storage_capacity(that.capacity()))
+        {
+            try
+            {
+                parallel_copy(policy, begin_, that.data(), that.size());
+            }
+            catch (...)
+            {
+                deallocate_storage(begin_.get_ptr(), capacity());
+                throw;
+            }
+            end_size_ = begin_ + that.size();
+        }
+
         ~vector()
         {
             destroy(begin_, end_size_);
-            std::allocator_traits<Allocator>::deallocate(allocator_, begin_.get_ptr(), capacity());
+            deallocate_storage(begin_.get_ptr(), capacity());
             begin_        = nullptr;
             end_size_     = nullptr;
             end_capacity_ = nullptr;
@@ -224,41 +605,41 @@ namespace my_std
         {
             if (this != &that)
             {
-                if (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value &&
-                    allocator_ != that.allocator_)
+                if constexpr (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value)
                 {
-                    this->~vector();
- 
-                    allocator_    = that.allocator_;
-                    begin_        = std::allocator_traits<Allocator>::allocate(allocator_, that.capacity());
-                    end_size_     = begin_ + that.size();
-                    end_capacity_ = begin_ + that.capacity();
+                    if (allocator_ != that.allocator_)
+                    {
+                        // the storage must be freed by the allocator which has allocated it
+                        destroy(begin_, end_size_);
+                        deallocate_storage(begin_.get_ptr(), capacity());
 
+                        begin_        = inline_.get();
+                        end_size_     = begin_;
+                        end_capacity_ = begin_ + InlineCapacity;
+                    }
+                    allocator_ = that.allocator_;
+                }
+
+                if (capacity() != that.capacity())
+                {
+                    destructive_realloc(that.capacity());
+                    end_size_ = begin_ + that.size();
                     copy_construct(begin_, that.begin_, that.end_size_);
                 }
                 else
                 {
-                    if (capacity() != that.capacity())
+                    copy_assign(begin_, that.begin_, that.begin_ + std::min(size(), that.size()));
+
+                    if (size() > that.size())
                     {
-                        destructive_realloc(that.capacity());
+                        destroy(begin_ + that.size(), end_size_);
                         end_size_ = begin_ + that.size();
-                        copy_construct(begin_, that.begin_, that.end_size_);
                     }
-                    else
+                    else if (size() < that.size())
                     {
-                        copy_assign(begin_, that.begin_, that.begin_ + std::min(size(), that.size()));
-
-                        if (size() > that.size())
-                        {
-                            destroy(begin_ + that.size(), end_size_);
-                            end_size_ = begin_ + that.size();
-                        }
-                        else if (size() < that.size())
-                        {
-                            size_type old_size = size();
-                            end_size_ = begin_ + that.size();
-                            copy_construct(begin_ + old_size, that.begin_ + old_size, that.end_size_);
-                        }
+                        size_type old_size = size();
+                        end_size_ = begin_ + that.size();
+                        copy_construct(begin_ + old_size, that.begin_ + old_size, that.end_size_);
                     }
                 }
             }
@@ -269,16 +650,35 @@ namespace my_std
         {
             if (this != &that)
             {
-                if (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
-                    allocator_ == that.allocator_)
+                constexpr bool propagate = std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value;
+
+                if (propagate || allocator_ == that.allocator_)
                 {
-                    std::swap(allocator_   , that.allocator_);
-                    std::swap(begin_       , that.begin_);
-                    std::swap(end_size_    , that.end_size_);
-                    std::swap(end_capacity_, that.end_capacity_);
+                    // the storage is freed by the current allocator, then the one of that comes along
+                    // with its storage; a non propagating allocator is never replaced
+                    clear();
+                    deallocate_storage(begin_.get_ptr(), capacity());
+
+                    if constexpr (propagate)
+                        allocator_ = std::move(that.allocator_);
+
+                    begin_        = inline_.get();
+                    end_size_     = begin_;
+                    end_capacity_ = begin_ + InlineCapacity;
+
+                    steal_storage(that);
                 }
                 else
                 {
+                    // storage of that can not be adopted, elements are moved one by one
+                    if (capacity() < that.size())
+                    {
+                        destructive_realloc(that.size());
+                        end_size_ = begin_ + that.size();
+                        move_construct(begin_, that.begin_, that.end_size_);
+                        return *this;
+                    }
+
                     move_assign(begin_, that.begin_, that.begin_ + std::min(size(), that.size()));
 
                     if (size() > that.size())
@@ -308,7 +708,7 @@ namespace my_std
             if (capacity() != count)
             {
                 destructive_realloc(count);
-                end_size_ = end_capacity_;
+                end_size_ = begin_ + count;
                 copy_construct(begin_, end_size_, value);
             }
             else
@@ -319,7 +719,7 @@ namespace my_std
                 if (size() < count)
                 {
                     size_type old_size = size();
-                    end_size_ = end_capacity_;
+                    end_size_ = begin_ + count;
                     copy_construct(begin_ + old_size, end_size_, value);
                 }
             }
@@ -328,27 +728,61 @@ namespace my_std
         VERIFICATION_TEMPLATE_CLASS_INPUT_IT
         void assign(InputIt first, InputIt last)
         {
-            size_type count = std::distance(first, last);
-            if (capacity() != count)
+            if constexpr (!is_forward_source_v<InputIt>)
             {
-                destructive_realloc(count);
-                end_size_ = end_capacity_;
-                copy_construct(begin_, first, last);
+                // the elements are assigned while both sides last, then the rest is destroyed or appended
+                iterator cur = begin_;
+                for (; cur != end_size_ && first != last; ++cur, ++first)
+                    *cur = *first;
+
+                destroy(cur, end_size_);
+                end_size_ = cur;
+
+                append_input(first, last);
             }
             else
             {
-                assert(size() <= count);
-
-                copy_assign(begin_, first, first + size());
-                if (size() < count)
+                size_type count = std::distance(first, last);
+                if (capacity() != count)
                 {
-                    size_type old_size = size();
-                    end_size_ = end_capacity_;
-                    copy_construct(begin_ + old_size, first + old_size, last);
+                    destructive_realloc(count);
+                    end_size_ = begin_ + count;
+                    copy_construct(begin_, first, last);
+                }
+                else
+                {
+                    assert(size() <= count);
+
+                    InputIt middle = std::next(first, size());
+
+                    copy_assign(begin_, first, middle);
+                    if (size() < count)
+                    {
+                        size_type old_size = size();
+                        end_size_ = begin_ + count;
+                        copy_construct(begin_ + old_size, middle, last);
+                    }
                 }
             }
         }
 
+        void assign(const parallel_policy &policy, size_type count, const_reference value)
+        {
+            if (points_into(&value))
+            {
+                value_type copy(value);
+                assign(policy, count, copy);
+                return;
+            }
+
+            clear(policy);
+            if (count > capacity())
+                destructive_realloc(count);
+
+            parallel_fill(policy, begin_, count, value);
+            end_size_ = begin_ + count;
+        }
+
         inline void assign(std::initializer_list<T> init_list)
         {
             assign(init_list.begin(), init_list.end());
@@ -362,26 +796,26 @@ namespace my_std
         reference at(size_type pos)
         {
             assert(pos < size());
-            return begin_[pos];
+            return begin_.get_ptr()[pos];
         }
 
         const_reference at(size_type pos) const
         {
             assert(pos < size());
-            return begin_[pos];
+            return begin_.get_ptr()[pos];
         }
 
         inline       reference operator [](size_type pos)       { return at(pos); }
         inline const_reference operator [](size_type pos) const { return at(pos); }
 
-        inline       reference front()       { *begin_; }
-        inline const_reference front() const { *begin_; }
+        inline       reference front()       { return *begin_; }
+        inline const_reference front() const { return *begin_; }
 
         inline       reference back ()       { return end_size_[-1]; }
         inline const_reference back () const { return end_size_[-1]; }
 
-        inline T       *data()       { return begin_; }
-        inline const T *data() const { return begin_; }
+        inline T       *data()       { return begin_.get_ptr(); }
+        inline const T *data() const { return begin_.get_ptr(); }
 
         inline iterator        begin()       { return begin_; }
         inline const_iterator  begin() const { return begin_; }
@@ -409,7 +843,7 @@ namespace my_std
         void reserve(size_type new_capacity)
         {
             if (new_capacity > capacity())
-                safe_realloc(new_capacity);
+                safe_realloc(GrowthPolicy::fit(new_capacity, sizeof(T)));
         }
 
         inline size_type capacity() const
@@ -423,14 +857,25 @@ namespace my_std
             end_size_ = begin_;
         }
 
+        // Destroys the elements on several threads. Call it before the destruction of a huge vector.
+        void clear(const parallel_policy &policy)
+        {
+            parallel_destroy(policy, begin_, end_size_);
+            end_size_ = begin_;
+        }
+
         iterator insert(const_iterator pos, const_reference value)
         {
             assert(pos >= begin_);
             assert(pos <= end_size_);
 
-            iterator new_pos = single_shift_right(pos);
-            std::allocator_traits<Allocator>::construct(allocator_, new_pos.get_ptr(), value);
-            return new_pos;
+            if (points_into(&value))
+                return insert(pos, value_type(value));
+
+            return shift_right(1, unconst(pos), [this, &value](T *gap)
+            {
+                std::allocator_traits<Allocator>::construct(allocator_, gap, value);
+            });
         }
 
         iterator insert(const_iterator pos, T &&value)
@@ -438,35 +883,67 @@ namespace my_std
             assert(pos >= begin_);
             assert(pos <= end_size_);
 
-            iterator new_pos = single_shift_right(pos);
-            std::allocator_traits<Allocator>::construct(allocator_, new_pos.get_ptr(), std::move(value));
-            return new_pos;
+            return shift_right(1, unconst(pos), [this, &value](T *gap)
+            {
+                std::allocator_traits<Allocator>::construct(allocator_, gap, std::move(value));
+            });
         }
 
         iterator insert(const_iterator pos, size_type count, const_reference value)
         {
-            if (count == 0) return pos;
+            if (count == 0) return unconst(pos);
 
             assert(pos >= begin_);
             assert(pos <= end_size_);
 
-            iterator new_pos = shift_right(count, pos);
-            copy_construct(new_pos, new_pos + count, value);
-            return new_pos;
+            if (points_into(&value))
+            {
+                value_type copy(value);
+                return insert(pos, count, copy);
+            }
+
+            return shift_right(count, unconst(pos), [this, count, &value](T *gap)
+            {
+                uninitialized_fill(gap, count, value);
+            });
         }
 
         VERIFICATION_TEMPLATE_CLASS_INPUT_IT
         iterator insert(const_iterator pos, InputIt first, InputIt last)
         {
-            if (last == first) return pos;
+            if (last == first) return unconst(pos);
 
             assert(pos >= begin_);
             assert(pos <= end_size_);
 
-            size_type count   = std::distance(first, last);
-            iterator  new_pos = shift_right(count, pos);
-            copy_construct(new_pos, first, last);
-            return new_pos;
+            if constexpr (!is_forward_source_v<InputIt>)
+            {
+                // appended in one pass, then rotated into place
+                size_type offset   = pos - begin_;
+                size_type old_size = size();
+
+                append_input(first, last);
+                std::rotate(begin_ + offset, begin_ + old_size, end_size_);
+                return begin_ + offset;
+            }
+            else
+            {
+                size_type count = std::distance(first, last);
+                return shift_right(count, unconst(pos), [this, first, last](T *gap)
+                {
+                    T *cur = gap;
+                    try
+                    {
+                        for (InputIt it = first; it != last; ++it, ++cur)
+                            std::allocator_traits<Allocator>::construct(allocator_, cur, *it);
+                    }
+                    catch (...)
+                    {
+                        my_detail::destroy_n(allocator_, gap, cur - gap);
+                        throw;
+                    }
+                });
+            }
         }
 
         inline iterator insert(const_iterator pos, std::initializer_list<T> init_list)
@@ -477,13 +954,17 @@ namespace my_std
         template <class... Args>
         iterator emplace(const_iterator pos, Args&&... args)
         {
-            assert(pos.get_ptr());
             assert(pos >= begin_);
-            assert(pos < end_size_);
+            assert(pos <= end_size_);
+
+            if (pos == end_size_)
+            {
+                emplace_back(std::forward<Args>(args)...);
+                return end_size_ - 1;
+            }
 
-            iterator new_pos = single_shift_right(pos);
-            std::allocator_traits<Allocator>::construct(allocator_, new_pos.get_ptr(), std::forward<Args>(args)...);
-            return new_pos;
+            // args may refer to elements which are shifted before the construction
+            return insert(pos, value_type(std::forward<Args>(args)...));
         }
 
         iterator erase(const_iterator pos)
@@ -492,41 +973,149 @@ namespace my_std
             assert(pos >= begin_);
             assert(pos < end_size_);
 
-            std::allocator_traits<Allocator>::destroy(allocator_, pos.get_ptr());
-            return shift_left(1, pos + 1);
+            std::allocator_traits<Allocator>::destroy(allocator_, unconst(pos).get_ptr());
+            return shift_left(1, unconst(pos) + 1);
         }
 
         iterator erase(const_iterator first, const_iterator last)
         {
             if (first == last)
-                return last;
+                return unconst(last);
 
             assert(begin_ <= first);
             assert(first < last);
             assert(last <= end_size_);
 
-            destroy(first, last);
-            return shift_left(last - first, last);
+            destroy(unconst(first), unconst(last));
+            return shift_left(last - first, unconst(last));
+        }
+
+        // Erases pos without shifting the tail: the last element is moved to its place,
+        // so the order of the elements is not kept. Returns pos.
+        iterator erase_unordered(const_iterator pos)
+        {
+            assert(pos.get_ptr());
+            assert(pos >= begin_);
+            assert(pos < end_size_);
+
+            iterator dst = unconst(pos);
+            std::allocator_traits<Allocator>::destroy(allocator_, dst.get_ptr());
+
+            if (dst != end_size_ - 1)
+                relocate(dst, end_size_ - 1, end_size_);
+
+            --end_size_;
+            return dst;
+        }
+
+        // Erases [first, last) and fills the gap with the elements from the end of the vector,
+        // at most last - first elements are moved. Returns first.
+        iterator erase_unordered(const_iterator first, const_iterator last)
+        {
+            if (first == last)
+                return unconst(last);
+
+            assert(begin_ <= first);
+            assert(first < last);
+            assert(last <= end_size_);
+
+            iterator  dst   = unconst(first);
+            size_type count = last - first;
+            size_type moved = std::min<size_type>(count, end_size_ - last);
+
+            destroy(dst, unconst(last));
+            relocate(dst, end_size_ - moved, end_size_);
+
+            end_size_ -= count;
+            return dst;
+        }
+
+        // Erases the elements at the sorted distinct positions in one pass, the kept elements
+        // between them are moved once, as blocks when relocatable.
+        void erase(std::span<const size_type> positions)
+        {
+            if (positions.empty())
+                return;
+
+            assert(std::is_sorted(positions.begin(), positions.end()));
+            assert(std::adjacent_find(positions.begin(), positions.end()) == positions.end());
+            assert(positions.back() < size());
+
+            T *data = begin_.get_ptr();
+            T *dst  = data + positions.front();
+
+            for (size_type idx = 0; idx < positions.size(); ++idx)
+            {
+                T *erased   = data + positions[idx];
+                T *run_last = idx + 1 < positions.size() ? data + positions[idx + 1] : end_size_.get_ptr();
+
+                std::allocator_traits<Allocator>::destroy(allocator_, erased);
+                dst = close_gap(dst, erased + 1, run_last);
+            }
+
+            end_size_ = begin_ + (dst - data);
+        }
+
+        // Erases the elements satisfying pred in one stable pass. Returns the number of erased
+        // elements. See also my_std::erase_if(vec, pred) and my_std::erase(vec, value).
+        template <class Pred>
+        size_type erase_if(Pred pred)
+        {
+            T *data = begin_.get_ptr();
+            T *last = end_size_.get_ptr();
+
+            T *dst = std::find_if(data, last, std::ref(pred));
+            T *cur = dst;
+
+            try
+            {
+                while (cur != last)
+                {
+                    // cur is erased, [cur + 1, run_last) is kept
+                    std::allocator_traits<Allocator>::destroy(allocator_, cur);
+
+                    T *run_last = std::find_if(cur + 1, last, std::ref(pred));
+                    dst = close_gap(dst, cur + 1, run_last);
+                    cur = run_last;
+                }
+            }
+            catch (...)
+            {
+                // pred has thrown, the rest is kept
+                dst = close_gap(dst, cur + 1, last);
+                end_size_ = begin_ + (dst - data);
+                throw;
+            }
+
+            end_size_ = begin_ + (dst - data);
+            return last - dst;
         }
 
         void push_back(const_reference value)
         {
-            ensure_free_capacity();
-            std::allocator_traits<Allocator>::construct(allocator_, end_size_.get_ptr(), value);
-            ++end_size_;
+            emplace_back(value);
         }
 
         void push_back(T &&value)
         {
-            ensure_free_capacity();
-            std::allocator_traits<Allocator>::construct(allocator_, end_size_.get_ptr(), std::move(value));
-            ++end_size_;
+            emplace_back(std::move(value));
         }
 
+        // In a full vector the new element is built in the new buffer before the old elements are
+        // moved there: args may refer to them.
         template <class... Args>
         reference emplace_back(Args&&... args)
         {
-            ensure_free_capacity();
+            assert(end_size_ <= end_capacity_);
+
+            if (end_size_ == end_capacity_)
+            {
+                return *shift_right(1, end_size_, [this, &args...](T *gap)
+                {
+                    std::allocator_traits<Allocator>::construct(allocator_, gap, std::forward<Args>(args)...);
+                });
+            }
+
             std::allocator_traits<Allocator>::construct(allocator_, end_size_.get_ptr(), std::forward<Args>(args)...);
             ++end_size_;
 
@@ -550,10 +1139,10 @@ namespace my_std
             }
             else
             {
-                safe_realloc(count);
+                ensure_capacity(count);
 
                 size_type old_size = size();
-                end_size_ = end_capacity_;
+                end_size_ = begin_ + count;
                 copy_construct(begin_ + old_size, end_size_, T());
             }
         }
@@ -567,28 +1156,211 @@ namespace my_std
                 destroy(begin_ + count, end_size_);
                 end_size_ = begin_ + count;
             }
+            else if (count > capacity() && points_into(&value))
+            {
+                value_type copy(value);
+                resize(count, copy);
+            }
             else
             {
-                safe_realloc(count);
+                ensure_capacity(count);
 
                 size_type old_size = size();
-                end_size_ = end_capacity_;
+                end_size_ = begin_ + count;
                 copy_construct(begin_ + old_size, end_size_, value);
             }
         }
 
+        void resize(const parallel_policy &policy, size_type count)
+        {
+            resize(policy, count, T());
+        }
+
+        void resize(const parallel_policy &policy, size_type count, const_reference value)
+        {
+            if (count <= size())
+            {
+                parallel_destroy(policy, begin_ + count, end_size_);
+                end_size_ = begin_ + count;
+                return;
+            }
+
+            if (points_into(&value))
+            {
+                value_type copy(value);
+                resize(policy, count, copy);
+                return;
+            }
+
+            ensure_capacity(count);
+            parallel_fill(policy, end_size_, count - size(), value);
+            end_size_ = begin_ + count;
+        }
+
+        // Like resize(count), but the new elements are left uninitialized (it is left to the caller
+        // to write them, e.g. by read() into a receive buffer).
+        void resize_uninitialized(size_type count)
+        {
+            static_assert(std::is_trivially_default_constructible_v<T>);
+
+            if (count < size())
+            {
+                destroy(begin_ + count, end_size_);
+                end_size_ = begin_ + count;
+            }
+            else
+            {
+                ensure_capacity(count);
+                end_size_ = begin_ + count;
+            }
+        }
+
+        // Appends count elements copied from src with one capacity check, by memcpy when T allows.
+        // src may point into the vector.
+        void append(const T *src, size_type count)
+        {
+            if (count == 0)
+                return;
+
+            shift_right(count, end_size_, [this, src, count](T *gap)
+            {
+                uninitialized_copy(gap, src, count);
+            });
+        }
+
+        // Appends the elements of the range. The length of a sized or forward range is taken once,
+        // a single pass range streams in after reserving size_hint more elements.
+        template <std::ranges::input_range Range>
+        void append_range(Range &&range, size_type size_hint = 0)
+        {
+            if constexpr (!std::ranges::sized_range<Range> && !std::ranges::forward_range<Range>)
+            {
+                reserve(size() + size_hint);
+                append_input(std::ranges::begin(range), std::ranges::end(range));
+            }
+            else if constexpr (std::ranges::contiguous_range<Range> &&
+                          std::is_same_v<std::ranges::range_value_t<Range>, T>)
+            {
+                append(std::ranges::data(range), std::ranges::distance(range));
+            }
+            else
+            {
+                size_type count = std::ranges::distance(range);
+                if (count == 0)
+                    return;
+
+                shift_right(count, end_size_, [this, &range](T *gap)
+                {
+                    T *cur = gap;
+                    try
+                    {
+                        for (auto &&elem : range)
+                            std::allocator_traits<Allocator>::construct(allocator_, cur++, std::forward<decltype(elem)>(elem));
+                    }
+                    catch (...)
+                    {
+                        my_detail::destroy_n(allocator_, gap, cur - gap);
+                        throw;
+                    }
+                });
+            }
+        }
+
+        // Appends count uninitialized elements and returns them for writing.
+        std::span<T> append_uninitialized(size_type count)
+        {
+            size_type old_size = size();
+            resize_uninitialized(old_size + count);
+
+            return std::span<T>(begin_.get_ptr() + old_size, count);
+        }
+
     private:
+        // Appends a single pass range element by element.
+        template <class InputIt, class Sentinel>
+        void append_input(InputIt first, Sentinel last)
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+
+        iterator unconst(const_iterator pos)
+        {
+            return begin_ + (pos - begin_);
+        }
+
+        bool is_inline()
+        {
+            return InlineCapacity != 0 && begin_.get_ptr() == inline_.get();
+        }
+
+        static size_type storage_capacity(size_type count)
+        {
+            return std::max(count, InlineCapacity);
+        }
+
+        // Heap storage is used only for more than InlineCapacity elements,
+        // so a capacity tells where the buffer is.
+        T *allocate_storage(size_type count)
+        {
+            if (count <= InlineCapacity)
+                return inline_.get();
+
+            return std::allocator_traits<Allocator>::allocate(allocator_, count);
+        }
+
+        void deallocate_storage(T *data, size_type count)
+        {
+            if (count <= InlineCapacity)
+                return;
+
+            std::allocator_traits<Allocator>::deallocate(allocator_, data, count);
+        }
+
+        // Takes the elements of that, when this holds no elements and no heap storage.
+        void steal_storage(vector &that)
+        {
+            assert(empty());
+            assert(is_inline() || capacity() == 0);
+
+            if (that.is_inline())
+            {
+                that.relocate(begin_, that.begin_, that.end_size_);
+                end_size_      = begin_ + that.size();
+                that.end_size_ = that.begin_;
+                return;
+            }
+
+            begin_        = that.begin_;
+            end_size_     = that.end_size_;
+            end_capacity_ = that.end_capacity_;
+
+            that.begin_        = that.inline_.get();
+            that.end_size_     = that.begin_;
+            that.end_capacity_ = that.begin_ + InlineCapacity;
+        }
+
         void safe_realloc(size_type new_capacity)
         {
             assert(new_capacity < max_size());
 
             size_type new_size = std::min(size(), new_capacity);
+            destroy(begin_ + new_size, end_size_);
 
-            T *new_begin = std::allocator_traits<Allocator>::allocate(allocator_, new_capacity);
-            move_construct(new_begin, begin_, begin_ + new_size);
+            T *new_begin = nullptr;
+            if constexpr (my_detail::has_reallocate<Allocator, T>::value && relocatable)
+            {
+                if (!is_inline() && new_capacity > InlineCapacity)
+                    new_begin = allocator_.reallocate(begin_.get_ptr(), capacity(), new_capacity);
+            }
 
-            destroy(begin_, end_size_);
-            std::allocator_traits<Allocator>::deallocate(allocator_, begin_.get_ptr(), capacity());
+            if (!new_begin)
+            {
+                new_begin = allocate_storage(new_capacity);
+                relocate(new_begin, begin_, begin_ + new_size);
+                deallocate_storage(begin_.get_ptr(), capacity());
+            }
+            new_capacity = storage_capacity(new_capacity);
 
             begin_        = new_begin;
             end_size_     = begin_ + new_size;
@@ -600,65 +1372,90 @@ namespace my_std
             assert(new_capacity < max_size());
 
             destroy(begin_, end_size_);
-            std::allocator_traits<Allocator>::deallocate(allocator_, begin_.get_ptr(), capacity());
+            deallocate_storage(begin_.get_ptr(), capacity());
 
-            begin_        = std::allocator_traits<Allocator>::allocate(allocator_, new_capacity);
+            begin_        = allocate_storage(new_capacity);
             end_size_     = begin_;
-            end_capacity_ = begin_ + new_capacity;
+            end_capacity_ = begin_ + storage_capacity(new_capacity);
         }
 
-        size_type recalc_capacity() const
+        void ensure_capacity(size_type required)
         {
-            return (capacity() == 0) ? default_capacity : (realloc_coef * capacity());
+            if (required > capacity())
+                safe_realloc(GrowthPolicy::grow(capacity(), required, sizeof(T)));
         }
 
-        void ensure_free_capacity()
+        // Opens a gap of shift_size uninitialized slots at shift_begin and constructs the inserted
+        // elements there with fill(gap). When the buffer is too small, the new one is assembled as
+        // prefix + inserted + suffix, so every old element is moved exactly once.
+        //
+        // fill must leave the gap uninitialized when it throws. The vector is then as before: the
+        // new buffer is dropped, or the tail is moved back over the gap.
+        template <class Filler>
+        iterator shift_right(size_type shift_size, iterator shift_begin, Filler fill)
         {
-            assert(end_size_ <= end_capacity_);
-
-            if (end_size_ == end_capacity_)
-            {
-                size_type new_capacity = recalc_capacity();
-                safe_realloc(new_capacity);
-            }
-        }
+            assert(shift_size != 0);
 
-        iterator single_shift_right(iterator shift_begin)
-        {
             assert(shift_begin >= begin_);
             assert(shift_begin <= end_size_);
 
             size_type shift_pos = shift_begin - begin_;
-            ensure_free_capacity();
-            shift_begin = begin_ + shift_pos;
+            size_type new_size  = size() + shift_size;
 
-            reverse_move_construct(end_size_, end_size_ - 1, shift_begin - 1);
+            if (new_size > capacity())
+            {
+                assert(new_size < max_size());
 
-            ++end_size_;
-            return shift_begin;
-        }
+                // new_capacity > capacity() >= InlineCapacity, so the new buffer is on the heap
+                size_type new_capacity = GrowthPolicy::grow(capacity(), new_size, sizeof(T));
+                T        *new_begin    = std::allocator_traits<Allocator>::allocate(allocator_, new_capacity);
 
-        iterator shift_right(size_type shift_size, iterator shift_begin)
-        {
-            assert(shift_size != 0);
+                // inserted elements go first: they may be built from the old elements
+                try
+                {
+                    fill(new_begin + shift_pos);
+                }
+                catch (...)
+                {
+                    deallocate_storage(new_begin, new_capacity);
+                    throw;
+                }
+                relocate(new_begin, begin_, shift_begin);
+                relocate(new_begin + shift_pos + shift_size, shift_begin, end_size_);
 
-            if (shift_size == 1)
-                return single_shift_right(shift_begin);
+                deallocate_storage(begin_.get_ptr(), capacity());
 
-            assert(shift_begin >= begin_);
-            assert(shift_begin <= end_size_);
+                begin_        = new_begin;
+                end_size_     = begin_ + new_size;
+                end_capacity_ = begin_ + new_capacity;
+                return begin_ + shift_pos;
+            }
 
-            size_type shift_pos    = shift_begin - begin_;
-            size_type new_size     = size() + shift_size;
-            size_type new_capacity = capacity();
-            while (new_size > new_capacity)
+            if constexpr (relocatable)
             {
-                new_capacity = recalc_capacity();
+                std::memmove(static_cast<void *>(shift_begin.get_ptr() + shift_size), shift_begin.get_ptr(),
+                             (end_size_ - shift_begin) * sizeof(T));
             }
-            safe_realloc(new_capacity);
-            shift_begin = begin_ + shift_pos;
+            else
+            {
+                // the last elements go to the uninitialized memory past the end,
+                // the rest are move assigned, the moved-from ones in the gap are destroyed
+                size_type moved = std::min<size_type>(shift_size, end_size_ - shift_begin);
 
-            reverse_move_construct(end_size_ + (shift_size - 1), end_size_ - 1, shift_begin - 1);
+                move_construct(end_size_ + (shift_size - moved), end_size_ - moved, end_size_);
+                std::move_backward(shift_begin.get_ptr(), end_size_.get_ptr() - moved, end_size_.get_ptr());
+                destroy(shift_begin, shift_begin + moved);
+            }
+
+            try
+            {
+                fill(shift_begin.get_ptr());
+            }
+            catch (...)
+            {
+                close_gap(shift_begin.get_ptr(), shift_begin.get_ptr() + shift_size, end_size_.get_ptr() + shift_size);
+                throw;
+            }
 
             end_size_ += shift_size;
             return shift_begin;
@@ -672,12 +1469,20 @@ namespace my_std
             assert(shift_begin >= begin_ + shift_size);
             assert(shift_begin <= end_size_);
 
-            move_construct(shift_begin - shift_size, shift_begin, end_size_);
+            close_gap((shift_begin - shift_size).get_ptr(), shift_begin.get_ptr(), end_size_.get_ptr());
 
             end_size_ -= shift_size;
             return shift_begin - shift_size;
         }
 
+        // Moves [first, last) down to dst, where the slots up to first are uninitialized.
+        // Returns the end of the moved elements.
+        T *close_gap(T *dst, T *first, T *last)
+        {
+            my_detail::relocate_down(allocator_, dst, first, last - first);
+            return dst + (last - first);
+        }
+
         void copy_construct(iterator begin, iterator end, const_reference value)
         {
             if (begin == end)
@@ -690,6 +1495,12 @@ namespace my_std
             assert(begin < end);
             assert(end <= end_size_);
 
+            if constexpr (constructible_by_memcpy)
+            {
+                my_detail::fill_n(begin.get_ptr(), end - begin, value);
+                return;
+            }
+
             for (; begin < end; ++begin)
                 std::allocator_traits<Allocator>::construct(
                     allocator_, begin.get_ptr(), value);
@@ -706,6 +1517,12 @@ namespace my_std
             assert(dst_begin >= begin_);
             assert(dst_begin < end_size_);
 
+            if constexpr (constructible_by_memcpy && is_contiguous_source_v<InputIt>)
+            {
+                my_detail::copy_n(dst_begin.get_ptr(), source_ptr(src_begin), src_end - src_begin);
+                return;
+            }
+
             for (; src_begin != src_end; ++src_begin, ++dst_begin)
                 std::allocator_traits<Allocator>::construct(
                     allocator_, dst_begin.get_ptr(), *src_begin);
@@ -724,17 +1541,101 @@ namespace my_std
                     allocator_, dst_begin.get_ptr(), std::move(*src_begin));
         }
 
-        VERIFICATION_TEMPLATE_CLASS_BIDIRECT_IT
-        void reverse_move_construct(iterator dst_begin, BidirectIt src_begin, BidirectIt src_end)
+        // Moves [src_begin, src_end) to the uninitialized dst_begin and ends the lifetime of the source.
+        void relocate(iterator dst_begin, iterator src_begin, iterator src_end)
         {
             if (src_begin == src_end)
                 return;
 
             assert(dst_begin.get_ptr());
 
-            for (; src_begin != src_end; --src_begin, --dst_begin)
-                std::allocator_traits<Allocator>::construct(
-                    allocator_, dst_begin.get_ptr(), std::move(*src_begin));
+            my_detail::relocate_n(allocator_, dst_begin.get_ptr(), src_begin.get_ptr(), src_end - src_begin);
+        }
+
+        bool points_into(const T *value) const
+        {
+            return std::less_equal<const T *>()(begin_.get_ptr(), value) &&
+                   std::less     <const T *>()(value, end_size_.get_ptr());
+        }
+
+        // Exception safe constructors of raw memory: nothing is left constructed when they throw.
+        void uninitialized_fill(T *dst, size_type count, const_reference value)
+        {
+            if constexpr (constructible_by_memcpy)
+            {
+                my_detail::fill_n(dst, count, value);
+                return;
+            }
+
+            T *cur = dst;
+            try
+            {
+                for (; cur != dst + count; ++cur)
+                    std::allocator_traits<Allocator>::construct(allocator_, cur, value);
+            }
+            catch (...)
+            {
+                my_detail::destroy_n(allocator_, dst, cur - dst);
+                throw;
+            }
+        }
+
+        void uninitialized_copy(T *dst, const T *src, size_type count)
+        {
+            if constexpr (constructible_by_memcpy)
+            {
+                my_detail::copy_n(dst, src, count);
+                return;
+            }
+
+            T *cur = dst;
+            try
+            {
+                for (; cur != dst + count; ++cur, ++src)
+                    std::allocator_traits<Allocator>::construct(allocator_, cur, *src);
+            }
+            catch (...)
+            {
+                my_detail::destroy_n(allocator_, dst, cur - dst);
+                throw;
+            }
+        }
+
+        void parallel_fill(const parallel_policy &policy, iterator dst, size_type count, const_reference value)
+        {
+            my_detail::parallel_construct(policy, count,
+                [this, dst, &value](size_t first, size_t last)
+                {
+                    uninitialized_fill(dst.get_ptr() + first, last - first, value);
+                },
+                [this, dst](size_t first, size_t last)
+                {
+                    my_detail::destroy_n(allocator_, dst.get_ptr() + first, last - first);
+                });
+        }
+
+        void parallel_copy(const parallel_policy &policy, iterator dst, const T *src, size_type count)
+        {
+            my_detail::parallel_construct(policy, count,
+                [this, dst, src](size_t first, size_t last)
+                {
+                    uninitialized_copy(dst.get_ptr() + first, src + first, last - first);
+                },
+                [this, dst](size_t first, size_t last)
+                {
+                    my_detail::destroy_n(allocator_, dst.get_ptr() + first, last - first);
+                });
+        }
+
+        void parallel_destroy(const parallel_policy &policy, iterator begin, iterator end)
+        {
+            if constexpr (std::is_trivially_destructible_v<T> && !my_detail::has_destroy<Allocator, T>::value)
+                return;
+
+            my_detail::parallel_for(policy, end - begin, [this, begin](size_t first, size_t last)
+            {
+                my_detail::destroy_n(allocator_, begin.get_ptr() + first, last - first);
+            });
         }
 
         void destroy(iterator begin, iterator end)
@@ -749,9 +1650,7 @@ namespace my_std
             assert(begin < end);
             assert(end <= end_size_);
 
-            for (; begin < end; ++begin)
-                std::allocator_traits<Allocator>::destroy(
-                    allocator_, begin.get_ptr());
+            my_detail::destroy_n(allocator_, begin.get_ptr(), end - begin);
         }
 
     // static functions
@@ -764,6 +1663,12 @@ namespace my_std
             assert(begin.get_ptr());
             assert(end  .get_ptr());
 
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                my_detail::fill_n(begin.get_ptr(), end - begin, value);
+                return;
+            }
+
             for (; begin < end; ++begin)
                 *begin = value;
         }
@@ -776,6 +1681,12 @@ namespace my_std
 
             assert(dst_begin.get_ptr());
 
+            if constexpr (std::is_trivially_copyable_v<T> && is_contiguous_source_v<InputIt>)
+            {
+                my_detail::copy_n(dst_begin.get_ptr(), source_ptr(src_begin), src_end - src_begin);
+                return;
+            }
+
             for (; src_begin != src_end; ++src_begin, ++dst_begin)
                 *dst_begin = *src_begin;
         }
@@ -790,23 +1701,63 @@ namespace my_std
                 *dst_begin = std::move(*src_begin);
         }
 
+        template <class InputIt>
+        static const T *source_ptr(InputIt it)
+        {
+            return std::to_address(it);
+        }
+
     // static data
     private:
-        static const size_type default_capacity = 4;
-        static const size_type realloc_coef     = 2;
+        static constexpr bool relocatable             = my_detail::is_relocatable_by_memcpy_v   <T, Allocator>;
+        static constexpr bool constructible_by_memcpy = my_detail::is_constructible_by_memcpy_v<T, Allocator>;
+
+        // Sources which may be walked twice, so their length may be taken in advance.
+        template <class InputIt>
+        static constexpr bool is_forward_source_v =
+            std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>;
+
+        // Sources which are plain arrays of T, so they may be copied with memcpy.
+        template <class InputIt>
+        static constexpr bool is_contiguous_source_v =
+            std::contiguous_iterator<InputIt> &&
+            std::is_same_v<std::remove_cv_t<typename std::iterator_traits<InputIt>::value_type>, T>;
 
     // member data
     private:
         Allocator allocator_;
+
+        [[no_unique_address]] my_detail::inline_storage<T, InlineCapacity> inline_;
+
         iterator  begin_;
         iterator  end_size_;
         iterator  end_capacity_;
     };
+
+    //--------------------------------------------------------------------------------------------------
+
+    template <class T, size_t N, class Allocator = std::allocator<T>, class GrowthPolicy = growth_x2>
+    using small_vector = vector<T, Allocator, GrowthPolicy, N>;
+
+    //--------------------------------------------------------------------------------------------------
+
+    template <class T, class Allocator, class GrowthPolicy, size_t N, class Pred>
+    size_t erase_if(vector<T, Allocator, GrowthPolicy, N> &vec, Pred pred)
+    {
+        return vec.erase_if(std::move(pred));
+    }
+
+    template <class T, class Allocator, class GrowthPolicy, size_t N, class U>
+    size_t erase(vector<T, Allocator, GrowthPolicy, N> &vec, const U &value)
+    {
+        // value may be an element, which is destroyed during the pass
+        const U value_copy = value;
+        return vec.erase_if([&value_copy](const T &elem) { return elem == value_copy; });
+    }
 }
 
 //==================================================================================================
 
 #undef VERIFICATION_TEMPLATE_CLASS_INPUT_IT
-#undef VERIFICATION_TEMPLATE_CLASS_BIDIRECT_IT
 
 #endif // VECTOR_HPP
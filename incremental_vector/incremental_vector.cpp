@@ -0,0 +1,52 @@
+#include "incremental_vector.hpp"
+#include <iostream>
+#include <string>
+
+//==================================================================================================
+
+static void print_header(const char *header)
+{
+    std::cout <<
+        "----------------------\n" <<
+        header << '\n' <<
+        "----------------------\n";
+}
+
+int main()
+{
+    my_std::incremental_vector<int, std::allocator<int>, 4> vec;
+
+    print_header("push_back(...): migration of 4 elements per push");
+    for (int i = 0; i < 40; ++i)
+    {
+        vec.push_back(i);
+        std::cout << "size = " << vec.size() << ", capacity = " << vec.capacity() <<
+                     ", migrating = " << vec.migrating() << "\n";
+    }
+
+    bool in_order = true;
+    for (size_t idx = 0; idx < vec.size(); ++idx)
+        in_order = in_order && vec[idx] == int(idx);
+    std::cout << "vec[i] == i: " << in_order << "\n";
+
+    print_header("pop_back() during migration");
+    my_std::incremental_vector<std::string, std::allocator<std::string>, 2> strings;
+    for (int i = 0; i < 9; ++i)
+        strings.push_back(std::string(32, char('a' + i)));
+
+    std::cout << "migrating = " << strings.migrating() << "\n";
+    strings.pop_back();
+    strings.pop_back();
+    std::cout << "migrating = " << strings.migrating() << "\n";
+    std::cout << strings << "\n";
+
+    print_header("incremental_vector(const incremental_vector &that)");
+    my_std::incremental_vector<std::string, std::allocator<std::string>, 2> strings_copy(strings);
+    std::cout << "equal to the original: " << std::equal(strings.begin(), strings.end(), strings_copy.begin()) << "\n";
+
+    print_header("reserve(100) + clear()");
+    vec.reserve(100);
+    std::cout << "capacity = " << vec.capacity() << ", migrating = " << vec.migrating() << "\n";
+    vec.clear();
+    std::cout << "size = " << vec.size() << ", migrating = " << vec.migrating() << "\n";
+}
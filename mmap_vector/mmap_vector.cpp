@@ -0,0 +1,96 @@
+#include "mmap_vector.hpp"
+#include <cstdio>
+
+//==================================================================================================
+
+struct record_t
+{
+    int    id;
+    double weight;
+};
+
+static const char *file_path = "mmap_vector.bin";
+
+static void print(const char *header, const my_std::mmap_vector<record_t> &vec)
+{
+    std::cout <<
+        "----------------------\n" <<
+        header << '\n' <<
+        "----------------------\n" <<
+        "size     = " << vec.size()     << "\n" <<
+        "capacity = " << vec.capacity() << "\n";
+
+    for (const record_t &record : vec)
+        std::cout << "{ " << record.id << ", " << record.weight << " } ";
+
+    std::cout << '\n';
+}
+
+int main()
+{
+    std::remove(file_path);
+
+    {
+        my_std::mmap_vector<record_t> vec(file_path);
+        print("mmap_vector(path) of a new file", vec);
+
+        for (int i = 0; i < 10; ++i)
+            vec.push_back({i, i * 0.5});
+        print("push_back(...) x10", vec);
+
+        vec.reserve(1000);
+        print("reserve(1000)", vec);
+
+        vec.flush();
+    }
+    {
+        my_std::mmap_vector<record_t> vec(file_path);
+        print("mmap_vector(path) of the existing file", vec);
+
+        vec.resize(12, record_t{-1, 0});
+        print("resize(12, { -1, 0 })", vec);
+
+        vec.pop_back();
+        print("pop_back()", vec);
+
+        while (vec.size() < vec.capacity())
+            vec.push_back(vec.back());
+        vec.emplace_back(vec[0]);
+
+        std::cout << "----------------------\nemplace_back(vec[0]) of a full vector\n----------------------\n";
+        std::cout << "size = " << vec.size() << ", back = { " << vec.back().id << ", " << vec.back().weight << " }\n";
+    }
+    {
+        try
+        {
+            my_std::mmap_vector<char> vec(file_path);
+        }
+        catch (const std::system_error &error)
+        {
+            std::cout << "----------------------\nmmap_vector<char>(path) of the record file\n----------------------\n";
+            std::cout << error.what() << '\n';
+        }
+    }
+
+    {
+        // size field of the header far beyond the end of the file
+        uint64_t bad_size = uint64_t(1) << 40;
+
+        FILE *file = std::fopen(file_path, "r+b");
+        std::fseek(file, 2 * sizeof(uint64_t), SEEK_SET);
+        std::fwrite(&bad_size, sizeof(bad_size), 1, file);
+        std::fclose(file);
+
+        try
+        {
+            my_std::mmap_vector<record_t> vec(file_path);
+        }
+        catch (const std::system_error &error)
+        {
+            std::cout << "----------------------\nmmap_vector(path) of a file with a corrupted size\n----------------------\n";
+            std::cout << error.what() << '\n';
+        }
+    }
+
+    std::remove(file_path);
+}
@@ -0,0 +1,88 @@
+#include "ring_buffer.hpp"
+#include <iostream>
+#include <string>
+
+//==================================================================================================
+
+static const int window_size = 4;
+
+static void print_header(const char *header)
+{
+    std::cout <<
+        "----------------------\n" <<
+        header << '\n' <<
+        "----------------------\n";
+}
+
+template <class Buffer>
+static void print_spans(const Buffer &buffer)
+{
+    auto [first, second] = buffer.spans();
+
+    std::cout << "first = {";
+    for (const auto &elem : first)
+        std::cout << " " << elem;
+    std::cout << " }, second = {";
+    for (const auto &elem : second)
+        std::cout << " " << elem;
+    std::cout << " }\n";
+}
+
+int main()
+{
+    print_header("sliding window: reserve once, pop_front + push_back");
+    my_std::ring_buffer<int> window;
+    window.reserve(window_size);
+    size_t capacity = window.capacity();
+
+    int sum = 0;
+    for (int sample = 1; sample <= 10; ++sample)
+    {
+        if (window.size() == window_size)
+        {
+            sum -= window.front();
+            window.pop_front();
+        }
+        window.push_back(sample);
+        sum += sample;
+
+        std::cout << "sample " << sample << ": sum = " << sum << "\n";
+    }
+    std::cout << window << "capacity unchanged: " << (window.capacity() == capacity) << "\n";
+    print_spans(window);
+
+    print_header("push_front, then growth of a wrapped buffer");
+    window.push_front(0);
+    window.push_front(-1);
+    std::cout << window;
+    print_spans(window);
+
+    print_header("append(src, 5) across the end of the buffer");
+    const int samples[] = {100, 101, 102, 103, 104};
+    window.pop_front(3);
+    window.append(samples, 5);
+    std::cout << window;
+    print_spans(window);
+
+    print_header("write through spans()");
+    auto [first, second] = window.spans();
+    for (int &elem : first)  elem *= -1;
+    for (int &elem : second) elem *= -1;
+    std::cout << window;
+
+    print_header("ring_buffer<std::string>: emplace_front(back()) on a full buffer");
+    my_std::ring_buffer<std::string> strings(2);
+    strings.push_back("alpha");
+    strings.push_front(std::string(20, 'x'));
+    strings.emplace_front(strings.back());
+    strings.emplace_back(strings.front());
+    std::cout << strings;
+
+    print_header("ring_buffer<std::string>: copy, pop_back, clear");
+    my_std::ring_buffer<std::string> copy(strings);
+    copy.pop_back();
+    copy.pop_front();
+    std::cout << copy;
+    strings.clear();
+    std::cout << strings;
+}
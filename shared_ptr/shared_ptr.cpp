@@ -29,4 +29,14 @@ int main()
 
         printf("\n");
     }
+
+    my_std::shared_ptr<shared_t> single = my_std::make_shared<shared_t>();
+    my_std::shared_ptr<shared_t> other;
+
+    other = single;
+    other = other;
+    printf("use_count after copy assignment: %zu\n", single.use_count());
+
+    other = my_std::make_shared<shared_t>();
+    printf("use_count after reassignment:    %zu\n", single.use_count());
 }
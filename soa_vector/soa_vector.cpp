@@ -0,0 +1,61 @@
+#include "soa_vector.hpp"
+#include <iostream>
+#include <numeric>
+#include <string>
+
+//==================================================================================================
+
+static void print_header(const char *header)
+{
+    std::cout <<
+        "----------------------\n" <<
+        header << '\n' <<
+        "----------------------\n";
+}
+
+template <class Vector>
+static void print_rows(const Vector &vec)
+{
+    std::cout << "size = " << vec.size() << ", capacity = " << vec.capacity() << "\n";
+    for (const auto &[id, price, name] : vec)
+        std::cout << id << " " << price << " " << name << "\n";
+}
+
+int main()
+{
+    my_std::soa_vector<int, double, std::string> vec;
+
+    print_header("push_back(...) x 10");
+    for (int i = 0; i < 10; ++i)
+        vec.push_back(i, i * 1.5, std::string(20, char('a' + i)));
+    print_rows(vec);
+
+    print_header("column<1>(): sum of the prices");
+    std::span<double> prices = vec.column<1>();
+    std::cout << std::accumulate(prices.begin(), prices.end(), 0.0) << "\n";
+
+    print_header("columns are aligned for their types");
+    std::cout << (reinterpret_cast<uintptr_t>(vec.column<1>().data()) % alignof(double) == 0) << "\n";
+
+    print_header("operator [](3) = {...} through the proxy row");
+    vec[3] = std::make_tuple(-3, -4.5, std::string("replaced"));
+    std::get<0>(vec[4]) = -4;
+    print_rows(vec);
+
+    print_header("emplace_back(fields of row 0) on growth");
+    while (vec.size() < vec.capacity())
+        vec.push_back(0, 0.0, "");
+    vec.emplace_back(std::get<0>(vec[0]), std::get<1>(vec[0]), std::get<2>(vec[0]));
+    std::cout << "size = " << vec.size() << ", back = " << std::get<2>(vec[vec.size() - 1]) << "\n";
+
+    print_header("copy + pop_back() x 8 + resize(4)");
+    my_std::soa_vector<int, double, std::string> vec_copy(vec);
+    for (int i = 0; i < 8; ++i)
+        vec_copy.pop_back();
+    vec_copy.resize(4);
+    print_rows(vec_copy);
+
+    print_header("clear()");
+    vec.clear();
+    print_rows(vec);
+}
@@ -1,6 +1,15 @@
 #include "vector.hpp"
+#include "malloc_allocator.hpp"
+#include "serialize.hpp"
+#include "memory_resource.hpp"
+#include "huge_page_allocator.hpp"
 #include <vector>
+#include <string>
+#include <atomic>
 #include <algorithm>
+#include <ranges>
+#include <sstream>
+#include <forward_list>
 
 //==================================================================================================
 
@@ -13,6 +22,23 @@ static void test_insert_emplace_erase();
 static void test_push_emplace_pop_back();
 static void test_resize();
 static void test_iterators();
+static void test_relocation();
+static void test_growth_policy();
+static void test_bulk_insert();
+static void test_small_vector();
+static void test_fill_copy_kernels();
+static void test_uninitialized_resize();
+static void test_contiguous_iterators();
+static void test_serialize();
+static void test_parallel();
+static void test_insert_exceptions();
+static void test_pmr();
+static void test_erase_if();
+static void test_erase_unordered();
+static void test_append();
+static void test_input_iterators();
+static void test_streaming_copy();
+static void test_huge_page_allocator();
 
 int main()
 {
@@ -25,6 +51,23 @@ int main()
     test_push_emplace_pop_back();
     test_resize();
     test_iterators();
+    test_relocation();
+    test_growth_policy();
+    test_bulk_insert();
+    test_small_vector();
+    test_fill_copy_kernels();
+    test_uninitialized_resize();
+    test_contiguous_iterators();
+    test_serialize();
+    test_parallel();
+    test_insert_exceptions();
+    test_pmr();
+    test_erase_if();
+    test_erase_unordered();
+    test_append();
+    test_input_iterators();
+    test_streaming_copy();
+    test_huge_page_allocator();
 }
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -103,6 +146,9 @@ public:
         return *this;
     }
 
+    size_t size() const { return size_; }
+    int operator [](size_t idx) const { return data_[idx]; }
+
     friend std::ostream &operator <<(std::ostream &output, const heavy_t &object);
 
 private:
@@ -110,6 +156,10 @@ private:
     size_t size_;
 };
 
+// heavy_t owns its array through a plain pointer, so its bytes can be moved to another address
+template <>
+struct my_std::is_trivially_relocatable<heavy_t>: std::true_type {};
+
 std::ostream &operator <<(std::ostream &output, const heavy_t &object)
 {
     output << "size = " << object.size_ << " { ";
@@ -425,6 +475,21 @@ static void test_push_emplace_pop_back()
             std::cout << vec;
         }
     }
+    {
+        my_std::vector<heavy_t> vec{
+            {1, 2},
+            {3, 4}};
+
+        vec.push_back(vec[0]);
+        print_subtest_header("push_back(vec[0]) of a full vector");
+        std::cout << vec;
+
+        while (vec.size() < vec.capacity())
+            vec.push_back(heavy_t{5});
+        vec.emplace_back(vec.back());
+        print_subtest_header("emplace_back(vec.back()) of a full vector");
+        std::cout << vec;
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -452,6 +517,10 @@ static void test_resize()
         vec.resize(10, heavy_t{10});
         print_subtest_header("resize(size_type count > size, const_reference)");
         std::cout << vec;
+
+        vec.resize(25, vec[5]);
+        print_subtest_header("resize(size_type count > capacity, vec[5])");
+        std::cout << "size = " << vec.size() << ", vec[24] = " << vec[24] << "\n";
     }
 }
 
@@ -478,3 +547,977 @@ static void test_iterators()
         std::cout << vec;
     }
 }
+
+//--------------------------------------------------------------------------------------------------
+
+static void test_relocation()
+{
+    PRINT_TEST_HEADER;
+
+    {
+        my_std::vector<heavy_t> vec;
+        for (int i = 0; i < 5; ++i)
+            vec.push_back(heavy_t{i, i + 1});
+
+        print_subtest_header("push_back(...) of trivially relocatable heavy_t");
+        std::cout << vec;
+    }
+    {
+        my_std::vector<int, my_std::malloc_allocator<int>> vec;
+        for (int i = 0; i < 9; ++i)
+            vec.push_back(i * i);
+
+        print_subtest_header("push_back(...) with malloc_allocator (realloc)");
+        std::cout << vec;
+
+        vec.reserve(100);
+        print_subtest_header("reserve(100) with malloc_allocator (realloc)");
+        std::cout << vec;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+template <class GrowthPolicy>
+static void print_capacity_sequence(const char *header)
+{
+    my_std::vector<int, std::allocator<int>, GrowthPolicy> vec;
+    size_t capacity = vec.capacity();
+
+    print_subtest_header(header);
+    std::cout << "capacity:";
+    for (int i = 0; i < 100; ++i)
+    {
+        vec.resize(vec.size() + 1);
+        if (vec.capacity() != capacity)
+        {
+            capacity = vec.capacity();
+            std::cout << " " << capacity;
+        }
+    }
+    std::cout << "\n";
+}
+
+static void test_growth_policy()
+{
+    PRINT_TEST_HEADER;
+
+    print_capacity_sequence<my_std::growth_x2>  ("resize(size() + 1) with growth_x2");
+    print_capacity_sequence<my_std::growth_x1_5>("resize(size() + 1) with growth_x1_5");
+
+    {
+        my_std::vector<char, std::allocator<char>, my_std::growth_size_class<>> vec;
+        vec.reserve(100);
+        print_subtest_header("reserve(100) with growth_size_class");
+        std::cout << "capacity = " << vec.capacity() << "\n";
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void test_bulk_insert()
+{
+    PRINT_TEST_HEADER;
+
+    {
+        my_std::vector<std::string> vec{"a", "b", "c", "d"};
+        vec.reserve(16);
+        std::cout << vec;
+
+        vec.insert(vec.begin() + 1, 2, std::string("x"));
+        print_subtest_header("insert(pos = #1, count = 2, value) without reallocation");
+        std::cout << vec;
+
+        vec.insert(vec.begin() + 2, 5, vec[0]);
+        print_subtest_header("insert(pos = #2, count = 5, vec[0]) without reallocation");
+        std::cout << vec;
+
+        std::vector<std::string> std_vec{"p", "q", "r", "s", "t", "u"};
+        vec.insert(vec.begin() + 3, std_vec.begin(), std_vec.end());
+        print_subtest_header("insert(pos = #3, InputIt first, InputIt last) with reallocation");
+        std::cout << vec;
+
+        vec.emplace(vec.begin(), 3, 'e');
+        print_subtest_header("emplace(pos = #0, 3, 'e')");
+        std::cout << vec;
+    }
+    {
+        my_std::vector<int> vec{1, 2, 3, 4};
+        std::cout << vec;
+
+        vec.insert(vec.begin() + 2, 3, 0);
+        print_subtest_header("insert(pos = #2, count = 3, value) of relocatable int");
+        std::cout << vec;
+
+        vec.insert(vec.begin() + 1, {7, 7});
+        print_subtest_header("insert(pos = #1, init_list) of relocatable int");
+        std::cout << vec;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void test_small_vector()
+{
+    PRINT_TEST_HEADER;
+
+    {
+        my_std::small_vector<std::string, 4> vec;
+        std::cout << vec;
+
+        for (int i = 0; i < 3; ++i)
+            vec.push_back(std::string(i + 1, 'a' + i));
+        print_subtest_header("push_back(...) x3 into inline storage");
+        std::cout << vec;
+
+        my_std::small_vector<std::string, 4> vec_inline_move(std::move(vec));
+        print_subtest_header("small_vector(small_vector &&inline)");
+        std::cout << "original " << vec;
+        print_thin_separator();
+        std::cout << "move " << vec_inline_move;
+
+        for (int i = 3; i < 6; ++i)
+            vec_inline_move.push_back(std::string(i + 1, 'a' + i));
+        print_subtest_header("push_back(...) x3 spilling to the heap");
+        std::cout << vec_inline_move;
+
+        my_std::small_vector<std::string, 4> vec_copy(vec_inline_move);
+        print_subtest_header("small_vector(const small_vector &heap)");
+        std::cout << "copy " << vec_copy;
+
+        vec = std::move(vec_copy);
+        print_subtest_header("operator =(small_vector &&heap)");
+        std::cout << "copy (source) " << vec_copy;
+        print_thin_separator();
+        std::cout << "original (destination) " << vec;
+
+        vec_copy = {"x", "y"};
+        vec = std::move(vec_copy);
+        print_subtest_header("operator =(small_vector &&inline)");
+        std::cout << "copy (source) " << vec_copy;
+        print_thin_separator();
+        std::cout << "original (destination) " << vec;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+struct rgb_t
+{
+    unsigned char r, g, b;
+};
+
+template <class T, class Equal>
+static void print_all_equal(const char *header, const my_std::vector<T> &vec, Equal equal)
+{
+    print_subtest_header(header);
+    std::cout << "size = " << vec.size() << ", all equal: " << std::all_of(vec.begin(), vec.end(), equal) << "\n";
+}
+
+static void test_fill_copy_kernels()
+{
+    PRINT_TEST_HEADER;
+
+    {
+        my_std::vector<int> vec(1003, 7);
+        print_all_equal("vector(count = 1003, int = 7)", vec, [](int x) { return x == 7; });
+
+        vec.resize(2005);
+        print_all_equal("resize(count = 2005) of int", my_std::vector<int>(vec.begin() + 1003, vec.end()),
+                        [](int x) { return x == 0; });
+
+        my_std::vector<int> vec_copy(vec);
+        print_all_equal("vector(const vector &that) of int", my_std::vector<int>(vec_copy.begin(), vec_copy.begin() + 1003),
+                        [](int x) { return x == 7; });
+    }
+    {
+        my_std::vector<double> vec(10);
+        vec.assign(517, 2.5);
+        print_all_equal("assign(count = 517, double = 2.5)", vec, [](double x) { return x == 2.5; });
+    }
+    {
+        my_std::vector<rgb_t> vec(77, rgb_t{1, 2, 3});
+        print_all_equal("vector(count = 77, rgb_t = {1, 2, 3})", vec,
+                        [](rgb_t x) { return x.r == 1 && x.g == 2 && x.b == 3; });
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void test_uninitialized_resize()
+{
+    PRINT_TEST_HEADER;
+
+    {
+        my_std::vector<char> buffer;
+
+        std::span<char> chunk = buffer.append_uninitialized(5);
+        std::memcpy(chunk.data(), "hello", chunk.size());
+        print_subtest_header("append_uninitialized(5) + memcpy(\"hello\")");
+        std::cout << buffer;
+
+        chunk = buffer.append_uninitialized(6);
+        std::memcpy(chunk.data(), " world", chunk.size());
+        print_subtest_header("append_uninitialized(6) + memcpy(\" world\")");
+        std::cout << buffer;
+
+        buffer.resize_uninitialized(3);
+        print_subtest_header("resize_uninitialized(3)");
+        std::cout << buffer;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static_assert(std::contiguous_iterator<my_std::vector<heavy_t>::iterator>);
+static_assert(std::contiguous_iterator<my_std::vector<heavy_t>::const_iterator>);
+static_assert(std::ranges::contiguous_range<my_std::vector<heavy_t>>);
+static_assert(!std::is_assignable_v<decltype(*std::declval<my_std::vector<heavy_t>::const_iterator>()), heavy_t>);
+
+static void test_contiguous_iterators()
+{
+    PRINT_TEST_HEADER;
+
+    {
+        my_std::vector<int> vec{5, 3, 9, 1, 7};
+        std::cout << vec;
+
+        std::sort(vec.begin(), vec.end());
+        print_subtest_header("std::sort(...)");
+        std::cout << vec;
+
+        my_std::vector<int> vec_copy(vec.size());
+        std::copy(vec.cbegin(), vec.cend(), vec_copy.begin());
+        print_subtest_header("std::copy(cbegin, cend, ...)");
+        std::cout << vec_copy;
+
+        std::ranges::reverse(vec);
+        print_subtest_header("std::ranges::reverse(...)");
+        std::cout << vec;
+    }
+    {
+        my_std::vector<heavy_t> vec{{1, 2}, {3, 4, 5}};
+
+        const my_std::vector<heavy_t> &const_vec = vec;
+        my_std::vector<heavy_t>::const_iterator it = const_vec.begin();
+
+        print_subtest_header("const_iterator::operator [](idx) returns a reference");
+        std::cout << it[1];
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+struct string_codec
+{
+    void encode(my_std::binary_writer &writer, const std::string &str)
+    {
+        writer.write(str.size());
+        writer.write(str.data(), str.size());
+    }
+
+    std::string decode(my_std::binary_reader &reader)
+    {
+        std::string str(reader.read<size_t>(), '\0');
+        reader.read(str.data(), str.size());
+        return str;
+    }
+};
+
+static void test_serialize()
+{
+    PRINT_TEST_HEADER;
+
+    {
+        FILE *file = std::tmpfile();
+        int   fd   = fileno(file);
+
+        my_std::vector<int> vec{1, 1, 2, 3, 5, 8, 13};
+        std::cout << vec;
+
+        my_std::serialize(fd, vec);
+        lseek(fd, 0, SEEK_SET);
+
+        my_std::vector<int> vec_loaded{100};
+        my_std::deserialize(fd, vec_loaded);
+        print_subtest_header("deserialize(serialize(vector<int>))");
+        std::cout << vec_loaded;
+
+        std::fclose(file);
+    }
+    {
+        FILE *file = std::tmpfile();
+        int   fd   = fileno(file);
+        string_codec codec;
+
+        my_std::vector<std::string> vec{"alpha", "", "gamma"};
+        std::cout << vec;
+
+        my_std::serialize(fd, vec, codec);
+        lseek(fd, 0, SEEK_SET);
+
+        my_std::vector<std::string> vec_loaded;
+        my_std::deserialize(fd, vec_loaded, codec);
+        print_subtest_header("deserialize(serialize(vector<std::string>, codec), codec)");
+        std::cout << vec_loaded;
+
+        lseek(fd, 0, SEEK_SET);
+        try
+        {
+            my_std::vector<int> vec_int;
+            my_std::deserialize(fd, vec_int);
+        }
+        catch (const std::system_error &error)
+        {
+            print_subtest_header("deserialize(vector<int>) of vector<std::string> data");
+            std::cout << error.what() << '\n';
+        }
+
+        std::fclose(file);
+    }
+    {
+        FILE *file = std::tmpfile();
+        int   fd   = fileno(file);
+        string_codec codec;
+
+        my_std::vector<std::string> first{"one", "two"};
+        my_std::vector<std::string> second{"three", "four", "five"};
+        my_std::vector<int>         third{3, 4, 5};
+
+        my_std::serialize(fd, first, codec);
+        my_std::serialize(fd, second, codec);
+        my_std::serialize(fd, third);
+        lseek(fd, 0, SEEK_SET);
+
+        my_std::vector<std::string> first_loaded;
+        my_std::vector<std::string> second_loaded;
+        my_std::vector<int>         third_loaded;
+
+        my_std::deserialize(fd, first_loaded, codec);
+        my_std::deserialize(fd, second_loaded, codec);
+        my_std::deserialize(fd, third_loaded);
+        print_subtest_header("three vectors back-to-back in one file");
+        std::cout << first_loaded << "\n" << second_loaded << "\n" << third_loaded;
+
+        std::fclose(file);
+    }
+    {
+        FILE *file = std::tmpfile();
+        int   fd   = fileno(file);
+        string_codec codec;
+
+        // a corrupted count field right after magic and elem_size
+        const uint64_t huge_count = UINT64_MAX / 2;
+
+        my_std::serialize(fd, my_std::vector<int>{1, 2, 3});
+        pwrite(fd, &huge_count, sizeof(huge_count), 2 * sizeof(uint64_t));
+        my_std::serialize(fd, my_std::vector<std::string>{"a"}, codec);
+        pwrite(fd, &huge_count, sizeof(huge_count), 5 * sizeof(uint64_t) + 3 * sizeof(int));
+        lseek(fd, 0, SEEK_SET);
+
+        print_subtest_header("deserialize(...) of a corrupted count");
+        try
+        {
+            my_std::vector<int> vec_int;
+            my_std::deserialize(fd, vec_int);
+        }
+        catch (const std::system_error &error)
+        {
+            std::cout << error.what() << '\n';
+        }
+
+        lseek(fd, 3 * sizeof(uint64_t) + 3 * sizeof(int), SEEK_SET);
+        try
+        {
+            my_std::vector<std::string> vec_string;
+            my_std::deserialize(fd, vec_string, codec);
+        }
+        catch (const std::system_error &error)
+        {
+            std::cout << error.what() << '\n';
+        }
+
+        std::fclose(file);
+    }
+    {
+        int pipe_fds[2];
+        if (pipe(pipe_fds) == -1)
+            return;
+
+        string_codec codec;
+
+        my_std::vector<std::string> first{"alpha", "beta"};
+        my_std::vector<int>         second{8, 13};
+        {
+            my_std::binary_writer writer(pipe_fds[1]);
+            my_std::serialize(writer, first, codec);
+            writer.flush();
+            my_std::serialize(pipe_fds[1], second);
+        }
+
+        my_std::vector<std::string> first_loaded;
+        my_std::vector<int>         second_loaded;
+        {
+            my_std::binary_reader reader(pipe_fds[0]);
+            my_std::deserialize(reader, first_loaded, codec);
+            my_std::deserialize(reader, second_loaded);
+        }
+        print_subtest_header("two vectors through a pipe with one binary_reader");
+        std::cout << first_loaded << "\n" << second_loaded;
+
+        close(pipe_fds[0]);
+        close(pipe_fds[1]);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// Counts live objects, copy construction throws once copies_left reaches zero (moves never throw).
+class counted_t
+{
+public:
+    counted_t(int value = 0):
+    value_(value)
+    {
+        ++alive;
+    }
+
+    counted_t(const counted_t &that):
+    value_(that.value_)
+    {
+        if (copies_left-- == 0)
+            throw std::runtime_error("counted_t: copy failed");
+        ++alive;
+    }
+
+    counted_t(counted_t &&that) noexcept:
+    value_(that.value_)
+    {
+        ++alive;
+    }
+
+    counted_t &operator =(const counted_t &that) = default;
+    counted_t &operator =(counted_t &&that)      = default;
+
+    ~counted_t()
+    {
+        --alive;
+    }
+
+    int value() const { return value_; }
+
+    static std::atomic<long> alive;
+    static std::atomic<long> copies_left;
+
+private:
+    int value_;
+};
+
+std::atomic<long> counted_t::alive       = 0;
+std::atomic<long> counted_t::copies_left = 1L << 40;
+
+static void test_parallel()
+{
+    PRINT_TEST_HEADER;
+
+    my_std::parallel_policy policy(4, 1000);
+
+    {
+        my_std::vector<int> vec(policy, 10000, 3);
+        print_all_equal("vector(policy, count = 10000, int = 3)", vec, [](int x) { return x == 3; });
+
+        vec.resize(policy, 25000, 4);
+        print_all_equal("resize(policy, count = 25000, int = 4)",
+                        my_std::vector<int>(vec.begin() + 10000, vec.end()), [](int x) { return x == 4; });
+
+        my_std::vector<int> vec_copy(policy, vec);
+        print_subtest_header("vector(policy, const vector &that)");
+        std::cout << "equal to the original: " << std::equal(vec.begin(), vec.end(), vec_copy.begin()) << "\n";
+
+        vec.assign(policy, 5000, 5);
+        print_all_equal("assign(policy, count = 5000, int = 5)", vec, [](int x) { return x == 5; });
+    }
+    {
+        my_std::vector<counted_t> vec(policy, 8000, counted_t(7));
+        print_subtest_header("vector(policy, count = 8000, counted_t)");
+        std::cout << "alive = " << counted_t::alive << "\n";
+
+        vec.clear(policy);
+        print_subtest_header("clear(policy)");
+        std::cout << "alive = " << counted_t::alive << "\n";
+
+        counted_t::copies_left = 6000;
+        try
+        {
+            my_std::vector<counted_t> vec_failed(policy, 8000, counted_t(7));
+        }
+        catch (const std::runtime_error &error)
+        {
+            print_subtest_header("vector(policy, count = 8000, counted_t) throwing on copy #6000");
+            std::cout << error.what() << ", alive = " << counted_t::alive << "\n";
+        }
+        counted_t::copies_left = 1L << 40;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+// counted_t whose bytes may be moved, so the tail of an insert is shifted with memmove.
+struct relocatable_counted_t: counted_t
+{
+    using counted_t::counted_t;
+};
+
+template <>
+struct my_std::is_trivially_relocatable<relocatable_counted_t>: std::true_type {};
+
+// others are the live counted_t objects outside of the vector
+template <class T>
+static void print_counted(const my_std::vector<T> &vec, long others)
+{
+    std::cout << "size = " << vec.size() << ", alive in the vector = " << counted_t::alive - others << " {";
+    for (const T &elem : vec)
+        std::cout << " " << elem.value();
+    std::cout << " }\n";
+}
+
+// Inserts into a vector with spare capacity, the copies of the inserted elements throw midway.
+template <class T>
+static void test_insert_exceptions_of(const char *type_name)
+{
+    long others = counted_t::alive;
+
+    my_std::vector<T> vec;
+    vec.reserve(16);
+    for (int value = 0; value < 6; ++value)
+        vec.emplace_back(value);
+
+    std::string header = std::string("insert(begin() + 2, 3, ") + type_name + "(9)) throwing on copy #2";
+    try
+    {
+        counted_t::copies_left = 2;
+        vec.insert(vec.begin() + 2, 3, T(9));
+    }
+    catch (const std::runtime_error &error)
+    {
+        print_subtest_header(header.c_str());
+        print_counted(vec, others);
+    }
+
+    T source[] = {T(10), T(11), T(12), T(13)};
+    others += std::size(source);
+
+    header = std::string("insert(begin() + 4, first, last) of 4 ") + type_name + " throwing on copy #3";
+    try
+    {
+        counted_t::copies_left = 3;
+        vec.insert(vec.begin() + 4, std::begin(source), std::end(source));
+    }
+    catch (const std::runtime_error &error)
+    {
+        print_subtest_header(header.c_str());
+        print_counted(vec, others);
+    }
+    counted_t::copies_left = 1L << 40;
+}
+
+static void test_insert_exceptions()
+{
+    PRINT_TEST_HEADER;
+
+    test_insert_exceptions_of<counted_t>("counted_t");
+    test_insert_exceptions_of<relocatable_counted_t>("relocatable_counted_t");
+}
+
+//--------------------------------------------------------------------------------------------------
+
+class counting_resource : public my_std::pmr::memory_resource
+{
+public:
+    size_t allocations   = 0;
+    size_t deallocations = 0;
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        ++allocations;
+        return my_std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *data, size_t bytes, size_t alignment) override
+    {
+        ++deallocations;
+        my_std::pmr::new_delete_resource()->deallocate(data, bytes, alignment);
+    }
+
+    bool do_is_equal(const my_std::pmr::memory_resource &that) const noexcept override
+    {
+        return this == &that;
+    }
+};
+
+static void print_resource(const char *header, const counting_resource &resource)
+{
+    print_subtest_header(header);
+    std::cout << "allocations = " << resource.allocations << ", deallocations = " << resource.deallocations << "\n";
+}
+
+static void test_pmr()
+{
+    PRINT_TEST_HEADER;
+
+    {
+        counting_resource upstream;
+        {
+            my_std::pmr::monotonic_buffer_resource arena(&upstream);
+
+            my_std::pmr::vector<int> vec_1(&arena);
+            my_std::pmr::vector<int> vec_2(&arena);
+            for (int i = 0; i < 1000; ++i)
+            {
+                vec_1.push_back(i);
+                vec_2.push_back(-i);
+            }
+            print_resource("monotonic_buffer_resource: 2 vectors x 1000 push_back(...)", upstream);
+            std::cout << "vec_1[999] = " << vec_1[999] << ", vec_2[999] = " << vec_2[999] << "\n";
+        }
+        print_resource("~monotonic_buffer_resource()", upstream);
+    }
+    {
+        alignas(std::max_align_t) char buffer[1024];
+        counting_resource upstream;
+
+        my_std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), &upstream);
+        my_std::pmr::vector<int> vec(&arena);
+        vec.reserve(100);
+
+        print_resource("monotonic_buffer_resource(buffer[1024]): reserve(100)", upstream);
+        std::cout << "storage is in the buffer: " << ((char *) vec.data() >= buffer && (char *) vec.data() < buffer + sizeof(buffer)) << "\n";
+    }
+    {
+        counting_resource upstream;
+        {
+            my_std::pmr::unsynchronized_pool_resource pool(&upstream);
+            my_std::pmr::vector<std::string> vec(&pool);
+
+            for (int i = 0; i < 100; ++i)
+                vec.emplace_back(1, char('a' + i % 26));
+            print_resource("unsynchronized_pool_resource: 100 emplace_back(...)", upstream);
+
+            for (int round = 0; round < 100; ++round)
+            {
+                my_std::pmr::vector<int> tmp(&pool);
+                tmp.resize(30);
+            }
+            print_resource("unsynchronized_pool_resource: 100 x (vector(30) + ~vector()), blocks are reused", upstream);
+
+            my_std::pmr::vector<char> big(&pool);
+            big.resize(100000);
+            print_resource("unsynchronized_pool_resource: resize(100000), straight from upstream", upstream);
+        }
+        print_resource("~unsynchronized_pool_resource()", upstream);
+    }
+    {
+        counting_resource upstream;
+        counting_resource fallback;
+        my_std::pmr::memory_resource *old_default = my_std::pmr::set_default_resource(&fallback);
+        {
+            my_std::pmr::monotonic_buffer_resource arena(&upstream);
+            my_std::pmr::vector<my_std::pmr::vector<int>> outer(&arena);
+
+            my_std::pmr::vector<int> source(5, 1, my_std::pmr::new_delete_resource());
+            for (int i = 0; i < 10; ++i)
+            {
+                outer.emplace_back(100, i);
+                outer.push_back(source);
+            }
+            outer[3].resize(1000);
+
+            bool in_arena = true;
+            for (const auto &inner : outer)
+                in_arena = in_arena && inner.get_allocator().resource() == &arena;
+
+            print_resource("vector<vector<int>> in an arena: 10 x (emplace_back(100, i) + push_back(source))", upstream);
+            std::cout << "inner vectors use the arena: " << in_arena << ", default resource allocations = " <<
+                         fallback.allocations << ", outer[18][99] = " << outer[18][99] << "\n";
+        }
+        my_std::pmr::set_default_resource(old_default);
+    }
+    {
+        counting_resource resource_1;
+        counting_resource resource_2;
+
+        my_std::pmr::vector<int> vec_1(&resource_1);
+        my_std::pmr::vector<int> vec_2(&resource_2);
+        vec_1.resize(10, 1);
+        vec_2.resize(20, 2);
+
+        vec_1 = vec_2;
+        print_subtest_header("operator =(const vector &that): allocator does not propagate");
+        std::cout << "vec_1 keeps its resource: " << (vec_1.get_allocator().resource() == &resource_1) <<
+                     ", vec_1[19] = " << vec_1[19] << "\n";
+
+        vec_1 = std::move(vec_2);
+        print_subtest_header("operator =(vector &&that): unequal allocators, elements are moved");
+        std::cout << "vec_1 keeps its resource: " << (vec_1.get_allocator().resource() == &resource_1) <<
+                     ", resource_2 deallocations = " << resource_2.deallocations << "\n";
+
+        my_std::pmr::vector<int> vec_3(vec_1);
+        print_subtest_header("vector(const vector &that): copy goes to the default resource");
+        std::cout << "default resource: " << (vec_3.get_allocator().resource() == my_std::pmr::get_default_resource()) << "\n";
+
+        my_std::pmr::vector<int> vec_4(&resource_1);
+        const int *data = vec_1.data();
+        vec_4 = std::move(vec_1);
+        print_subtest_header("operator =(vector &&that): equal allocators, storage is adopted");
+        std::cout << "same storage: " << (vec_4.data() == data) << "\n";
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+template <class Vector>
+static void print_elements(const char *header, const Vector &vec)
+{
+    print_subtest_header(header);
+    std::cout << "size = " << vec.size() << " {";
+    for (const auto &elem : vec)
+        std::cout << " " << elem;
+    std::cout << " }\n";
+}
+
+static void test_erase_if()
+{
+    PRINT_TEST_HEADER;
+
+    {
+        my_std::vector<int> vec;
+        for (int i = 0; i < 20; ++i)
+            vec.push_back(i);
+
+        size_t erased = my_std::erase_if(vec, [](int x) { return x % 3 == 0; });
+        print_elements("erase_if(vec, x % 3 == 0)", vec);
+        std::cout << "erased = " << erased << "\n";
+
+        vec.push_back(7);
+        vec.push_back(7);
+        erased = my_std::erase(vec, vec[4]);
+        print_elements("erase(vec, vec[4] = 7)", vec);
+        std::cout << "erased = " << erased << "\n";
+
+        const size_t positions[] = {0, 1, 5, 9};
+        vec.erase(std::span<const size_t>(positions));
+        print_elements("erase(positions = {0, 1, 5, 9})", vec);
+    }
+    {
+        my_std::vector<std::string> vec;
+        for (int i = 0; i < 12; ++i)
+            vec.push_back(std::string(20, char('a' + i)));
+
+        my_std::erase_if(vec, [](const std::string &str) { return (str[0] - 'a') % 2 == 1; });
+        print_elements("vector<std::string>: erase_if(odd letters)", vec);
+
+        const size_t positions[] = {1, 2};
+        vec.erase(std::span<const size_t>(positions));
+        print_elements("vector<std::string>: erase(positions = {1, 2})", vec);
+
+        vec.erase(vec.begin());
+        print_elements("vector<std::string>: erase(begin())", vec);
+    }
+    {
+        my_std::vector<heavy_t> vec{{1}, {2, 2}, {3}, {4, 4}, {5}};
+
+        my_std::erase_if(vec, [](const heavy_t &heavy) { return heavy.size() == 2; });
+        print_subtest_header("vector<heavy_t>: erase_if(size == 2)");
+        std::cout << vec << "\n";
+
+        bool thrown = false;
+        try
+        {
+            my_std::erase_if(vec, [](const heavy_t &heavy) -> bool
+            {
+                if (heavy.size() == 1 && heavy[0] == 5) throw std::runtime_error("pred has thrown");
+                return heavy[0] == 1;
+            });
+        }
+        catch (const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        print_subtest_header("vector<heavy_t>: erase_if(...) throwing on the last element");
+        std::cout << "thrown = " << thrown << "\n" << vec << "\n";
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void test_erase_unordered()
+{
+    PRINT_TEST_HEADER;
+
+    {
+        my_std::vector<int> vec;
+        for (int i = 0; i < 10; ++i)
+            vec.push_back(i);
+
+        vec.erase_unordered(vec.begin() + 2);
+        print_elements("erase_unordered(begin() + 2)", vec);
+
+        vec.erase_unordered(vec.end() - 1);
+        print_elements("erase_unordered(end() - 1)", vec);
+
+        vec.erase_unordered(vec.begin(), vec.begin() + 3);
+        print_elements("erase_unordered(begin(), begin() + 3)", vec);
+
+        vec.erase_unordered(vec.begin() + 1, vec.end() - 1);
+        print_elements("erase_unordered(begin() + 1, end() - 1)", vec);
+    }
+    {
+        my_std::vector<std::string> vec;
+        for (int i = 0; i < 8; ++i)
+            vec.push_back(std::string(20, char('a' + i)));
+
+        vec.erase_unordered(vec.begin());
+        print_elements("vector<std::string>: erase_unordered(begin())", vec);
+
+        vec.erase_unordered(vec.begin() + 2, vec.begin() + 5);
+        print_elements("vector<std::string>: erase_unordered(begin() + 2, begin() + 5)", vec);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void test_append()
+{
+    PRINT_TEST_HEADER;
+
+    {
+        my_std::vector<int> vec;
+        const int chunk[] = {1, 2, 3, 4, 5};
+
+        vec.append(chunk, 5);
+        print_elements("append(chunk, 5)", vec);
+
+        vec.append(vec.data() + 1, 3);
+        print_elements("append(data() + 1, 3): source inside the vector", vec);
+
+        vec.append_range(std::vector<int>{10, 20});
+        print_elements("append_range(std::vector<int>{10, 20})", vec);
+
+        vec.append_range(std::views::iota(100, 104));
+        print_elements("append_range(iota(100, 104))", vec);
+
+        vec.append_range(vec);
+        print_elements("append_range(vec): the vector itself", vec);
+    }
+    {
+        my_std::vector<std::string> vec;
+        const std::string words[] = {"alpha", "beta", "gamma"};
+
+        vec.append(words, 3);
+        vec.append_range(words | std::views::reverse);
+        print_elements("vector<std::string>: append(words, 3) + append_range(words | reverse)", vec);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void test_input_iterators()
+{
+    PRINT_TEST_HEADER;
+
+    {
+        std::istringstream input("1 2 3 4 5 6 7 8 9 10");
+        my_std::vector<int> vec{std::istream_iterator<int>(input), std::istream_iterator<int>()};
+        print_elements("vector(istream_iterator, istream_iterator)", vec);
+
+        std::istringstream shorter("-1 -2 -3");
+        vec.assign(std::istream_iterator<int>(shorter), std::istream_iterator<int>());
+        print_elements("assign(istream_iterator(\"-1 -2 -3\"), ...)", vec);
+
+        std::istringstream longer("11 12 13 14 15");
+        vec.assign(std::istream_iterator<int>(longer), std::istream_iterator<int>());
+        print_elements("assign(istream_iterator(\"11 12 13 14 15\"), ...)", vec);
+
+        std::istringstream middle("0 0");
+        vec.insert(vec.begin() + 2, std::istream_iterator<int>(middle), std::istream_iterator<int>());
+        print_elements("insert(begin() + 2, istream_iterator(\"0 0\"), ...)", vec);
+
+        std::istringstream tail("7 8 9");
+        vec.append_range(std::ranges::subrange(std::istream_iterator<int>(tail), std::istream_iterator<int>()), 3);
+        print_elements("append_range(istream range, size_hint = 3)", vec);
+    }
+    {
+        std::forward_list<std::string> list{"one", "two", "three"};
+
+        my_std::vector<std::string> vec(list.begin(), list.end());
+        print_elements("vector<std::string>(forward_list::iterator, ...)", vec);
+        std::cout << "capacity = " << vec.capacity() << "\n";
+
+        std::istringstream input("four five");
+        vec.insert(vec.begin() + 1, std::istream_iterator<std::string>(input), std::istream_iterator<std::string>());
+        print_elements("vector<std::string>: insert(begin() + 1, istream_iterator(\"four five\"), ...)", vec);
+
+        vec.assign(list.begin(), list.end());
+        print_elements("vector<std::string>: assign(forward_list::iterator, ...)", vec);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void test_streaming_copy()
+{
+    PRINT_TEST_HEADER;
+
+    size_t default_threshold = my_detail::streaming_threshold();
+    print_subtest_header("streaming_threshold() is detected");
+    std::cout << "threshold > 0: " << (default_threshold > 0) << "\n";
+
+    my_detail::set_streaming_threshold(4096);
+    {
+        my_std::vector<int> vec;
+        for (int i = 0; i < 100003; ++i)
+            vec.push_back(i);
+
+        my_std::vector<int> vec_copy(vec);
+        print_subtest_header("vector(const vector &that) of 100003 ints, streaming from 4096 bytes");
+        std::cout << "equal to the original: " << std::equal(vec.begin(), vec.end(), vec_copy.begin(), vec_copy.end()) << "\n";
+
+        my_std::vector<int> vec_unaligned(vec.begin() + 1, vec.end());
+        print_subtest_header("vector(begin() + 1, end()): unaligned source");
+        std::cout << "equal to the original: " << std::equal(vec.begin() + 1, vec.end(), vec_unaligned.begin(), vec_unaligned.end()) << "\n";
+
+        vec.reserve(300000);
+        print_subtest_header("reserve(300000): streaming relocation");
+        bool in_order = true;
+        for (size_t idx = 0; idx < vec.size(); ++idx)
+            in_order = in_order && vec[idx] == int(idx);
+        std::cout << "vec[i] == i: " << in_order << "\n";
+    }
+    my_detail::set_streaming_threshold(default_threshold);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+static void test_huge_page_allocator()
+{
+    PRINT_TEST_HEADER;
+
+    using allocator_t = my_std::huge_page_allocator<int>;
+
+    my_std::vector<int, allocator_t> vec(100, 1);
+    print_subtest_header("vector(100, 1): small block from the heap");
+    std::cout << "huge_page_bytes = " << allocator_t::huge_page_bytes(vec.data(), vec.capacity()) << "\n";
+
+    vec.resize(4 * 1024 * 1024, 2);
+    print_subtest_header("resize(4M, 2): mapped block");
+    std::cout << "2 MiB aligned: " << (reinterpret_cast<uintptr_t>(vec.data()) % (2 * 1024 * 1024) == 0) << "\n";
+    std::cout << "vec[99] = " << vec[99] << ", vec[100] = " << vec[100] << ", back() = " << vec.back() << "\n";
+
+    size_t huge_bytes = allocator_t::huge_page_bytes(vec.data(), vec.capacity());
+    std::cout << "huge_page_bytes <= block size: " << (huge_bytes <= vec.capacity() * sizeof(int)) << "\n";
+
+    vec.resize(12 * 1024 * 1024, 3);
+    print_subtest_header("resize(12M, 3): grown with mremap");
+    std::cout << "vec[0] = " << vec[0] << ", vec[4M] = " << vec[4 * 1024 * 1024] << ", back() = " << vec.back() << "\n";
+}